@@ -1,5 +1,33 @@
-CREATE INDEX nodes_version_idx ON public.nodes (version);
-CREATE INDEX ways_poly_version_idx ON public.ways_poly (version);
-CREATE INDEX ways_line_version_idx ON public.ways_line (version);
-CREATE INDEX idx_changesets_hashtags ON public.changesets USING gin(hashtags);
+-- Indexes created after a bootstrap, or rebuilt with underpass --reindex.
+-- There is one index for every statement, they are built in parallel on
+-- separate connections, so they must not depend on each other.
 
+-- Versions, for the version checks of the replicator
+CREATE INDEX IF NOT EXISTS nodes_version_idx ON public.nodes (version);
+CREATE INDEX IF NOT EXISTS ways_poly_version_idx ON public.ways_poly (version);
+CREATE INDEX IF NOT EXISTS ways_line_version_idx ON public.ways_line (version);
+
+-- Spatial lookups
+CREATE INDEX IF NOT EXISTS nodes_geom_idx ON public.nodes USING gist (geom);
+CREATE INDEX IF NOT EXISTS ways_poly_geom_idx ON public.ways_poly USING gist (geom);
+CREATE INDEX IF NOT EXISTS ways_line_geom_idx ON public.ways_line USING gist (geom);
+CREATE INDEX IF NOT EXISTS relations_geom_idx ON public.relations USING gist (geom);
+
+-- Refs and members, the replicator uses way_refs and relation_members
+CREATE INDEX IF NOT EXISTS ways_poly_refs_idx ON public.ways_poly USING gin (refs);
+CREATE INDEX IF NOT EXISTS ways_line_refs_idx ON public.ways_line USING gin (refs);
+CREATE INDEX IF NOT EXISTS relations_refs_idx ON public.relations USING gin (refs jsonb_path_ops);
+CREATE INDEX IF NOT EXISTS way_refs_node_id_idx ON public.way_refs (node_id);
+CREATE INDEX IF NOT EXISTS relation_members_member_idx ON public.relation_members (member_type, member_ref);
+
+-- Timestamps. A bootstrap loads the rows in id order, so the timestamps of
+-- the imported blocks are mixed and BRIN can't tell them apart, but none is
+-- newer than the import. Rows written by the replicator after it mostly go to
+-- new blocks, so BRIN indexes are tiny and good for the changes since the
+-- import, not for searching older timestamps.
+CREATE INDEX IF NOT EXISTS nodes_timestamp_idx ON public.nodes USING brin (timestamp);
+CREATE INDEX IF NOT EXISTS ways_poly_timestamp_idx ON public.ways_poly USING brin (timestamp);
+CREATE INDEX IF NOT EXISTS ways_line_timestamp_idx ON public.ways_line USING brin (timestamp);
+CREATE INDEX IF NOT EXISTS relations_timestamp_idx ON public.relations USING brin (timestamp);
+
+CREATE INDEX IF NOT EXISTS idx_changesets_hashtags ON public.changesets USING gin (hashtags);
@@ -71,6 +71,15 @@ CREATE TABLE IF NOT EXISTS public.nodes (
     uid int8
 );
 
+-- Reverse index of the Nodes referenced by Ways, used for finding the Ways
+-- affected by a change on a Node. It's kept in sync with the refs column
+-- of ways_poly and ways_line by the replicator, which also creates and
+-- fills it when it starts on a database that doesn't have it.
+CREATE TABLE IF NOT EXISTS public.way_refs (
+    way_id int8 NOT NULL,
+    node_id int8 NOT NULL
+);
+
 CREATE TABLE IF NOT EXISTS public.relations (
     osm_id int8,
     changeset int8,
@@ -83,6 +92,17 @@ CREATE TABLE IF NOT EXISTS public.relations (
     uid int8
 );
 
+-- Reverse index of the members of Relations, used for finding the Relations
+-- affected by a change on a Way. The member type is the first letter of the
+-- type (n, w or r). It's kept in sync with the refs column of relations by
+-- the replicator, which also creates and fills it when it starts on a
+-- database that doesn't have it.
+CREATE TABLE IF NOT EXISTS public.relation_members (
+    relation_id int8 NOT NULL,
+    member_type char(1) NOT NULL,
+    member_ref int8 NOT NULL
+);
+
 ALTER TABLE ONLY public.ways_poly
     ADD CONSTRAINT ways_poly_pkey PRIMARY KEY (osm_id);
 
@@ -95,5 +115,11 @@ ALTER TABLE ONLY public.nodes
 ALTER TABLE ONLY public.relations
     ADD CONSTRAINT relations_pkey PRIMARY KEY (osm_id);
 
+ALTER TABLE ONLY public.way_refs
+    ADD CONSTRAINT way_refs_pkey PRIMARY KEY (way_id, node_id);
+
+ALTER TABLE ONLY public.relation_members
+    ADD CONSTRAINT relation_members_pkey PRIMARY KEY (relation_id, member_type, member_ref);
+
 ALTER TABLE ONLY public.changesets
     ADD CONSTRAINT changesets_pkey PRIMARY KEY (id);
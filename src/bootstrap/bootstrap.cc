@@ -18,6 +18,15 @@
 //     along with Underpass.  If not, see <https://www.gnu.org/licenses/>.
 //
 
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <functional>
+#include <map>
+#include <regex>
+#include <boost/algorithm/string.hpp>
+#include <boost/asio/post.hpp>
+#include <boost/asio/thread_pool.hpp>
 #include "underpassconfig.hh"
 #include "raw/queryraw.hh"
 #include "bootstrap/osmprocessor.hh"
@@ -35,45 +44,66 @@ namespace bootstrap {
     Bootstrap::Bootstrap(void) {}
 
     bool
-    Bootstrap::connect(const std::string &db_url) {
+    Bootstrap::connect(const std::string &db_url, std::size_t pool_size) {
         db = std::make_shared<Pq>();
-        if (!db->connect(db_url)) {
+        if (!db->connect(db_url, pool_size)) {
             log_error("Could not connect to Underpass DB, aborting bootstrapping thread!");
             return false;
         }
         queryraw = std::make_shared<QueryRaw>(db);
+        this->pool_size = pool_size;
         return true;
     }
 
-    void
-    Bootstrap::processPBF(std::string &pbf, int page_size, int concurrency) {
+    bool
+    Bootstrap::processPBF(std::string &pbf, const underpassconfig::UnderpassConfig &config) {
         std::cout << "Processing PBF ... (" << pbf << ")" << std::endl;
 
-        auto rawTasker = std::make_shared<RawTasker>(db, queryraw, page_size, concurrency);
+        auto rawTasker = std::make_shared<RawTasker>(db, queryraw, config.bootstrap_page_size, config.concurrency, config.bulkload);
         auto osmProcessor = OsmProcessor(rawTasker, pbf);
+        osmProcessor.location_index = config.location_index;
+        osmProcessor.location_index_file = config.location_index_file;
 
-        std::cout << "Processing nodes and ways ..." << std::endl;
-        osmProcessor.nodesAndWays();
-
-        std::cout << "Processing relations  ..." << std::endl;
-        osmProcessor.relations();
+        // Seed the node locations index used by the replicator, the
+        // locations of a previous import are discarded
+        if (!config.node_locations.empty()) {
+            auto nodelocations = std::make_shared<osmobjects::NodeLocations>();
+            if (nodelocations->open(config.node_locations, true)) {
+                osmProcessor.nodelocations = nodelocations;
+            }
+        }
 
-        std::cout << "Processing relations  (geometries)..." << std::endl;
-        osmProcessor.relationsGeometries();
+        std::cout << "Processing nodes, ways and relations ..." << std::endl;
+        if (!osmProcessor.process()) {
+            std::cout << "Error processing the PBF file" << std::endl;
+            return false;
+        }
 
+        // The index has seen everything in the database
+        if (osmProcessor.nodelocations) {
+            osmProcessor.nodelocations->setDatabase(queryraw->getDatabaseId());
+            auto newest = queryraw->getNewestTimestamp();
+            if (newest != boost::posix_time::not_a_date_time) {
+                osmProcessor.nodelocations->setTimestamp(boost::posix_time::to_time_t(newest));
+            }
+            osmProcessor.nodelocations->sync();
+        }
+        return true;
     }
 
-    void
+    bool
     Bootstrap::start(const underpassconfig::UnderpassConfig &config) {
-        if (!connect(config.underpass_db_url)) {
+        // One connection for every thread writing the data
+        if (!connect(config.underpass_db_url, config.db_pool_size ? config.db_pool_size : config.concurrency)) {
             std::cout << "Error trying to connect to the database" << std::endl;
-            exit(0);
+            return false;
         }
         queryraw = std::make_shared<QueryRaw>(db);
         std::string pbf = config.import;
         if (!config.latest && !pbf.empty()) {
-            processPBF(pbf, config.bootstrap_page_size, config.concurrency);
+            return processPBF(pbf, config);
         }
+        return true;
     }
 
     boost::posix_time::ptime
@@ -81,18 +111,315 @@ namespace bootstrap {
         return queryraw->getLatestTimestamp();
     }
 
-    void
-    Bootstrap::initializeDB(void) {
+    // The raw tables, and the largest id expected in each one, for
+    // splitting them in ranges. Larger ids go to the last partition.
+    static const std::vector<std::pair<std::string, long>> rawTables = {
+        {"nodes", 16000000000},
+        {"ways_poly", 2000000000},
+        {"ways_line", 2000000000},
+        {"relations", 32000000}
+    };
+
+    // The tables written by a bulk load, and their primary keys
+    static const std::string bulkTables = "nodes|ways_poly|ways_line|relations|way_refs|relation_members";
+    static const std::regex primaryKey("ALTER TABLE ONLY public\\.(" + bulkTables + ")\\s+ADD CONSTRAINT (\\w+) PRIMARY KEY \\([^)]*\\);");
+
+    static std::string
+    readFile(const std::string &filepath) {
+        std::ifstream file(filepath);
+        if (!file.is_open()) {
+            log_error("Could not open SQL file: %1%", filepath);
+            return "";
+        }
+        return std::string{std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+    }
+
+    bool
+    Bootstrap::createTables(const std::string &sql) {
+        // Pq::query() only logs the errors
+        bool committed = false;
+        db->execute("underpass.sql", [&sql, &committed](Pq::Lease &conn) {
+            pqxx::work worker(*conn);
+            worker.exec(sql);
+            worker.commit();
+            committed = true;
+            return pqxx::result();
+        });
+        return committed;
+    }
+
+    bool
+    Bootstrap::initializeDB(unsigned int partitions, bool bulkload) {
         std::string filepath = ETCDIR;
         filepath += "/setup/underpass.sql";
-        db->queryFile(filepath);
+        std::string sql = readFile(filepath);
+        if (sql.empty()) {
+            return false;
+        }
+        if (partitions < 2 && !bulkload) {
+            return createTables(sql);
+        }
+
+        // CREATE TABLE IF NOT EXISTS keeps a table without partitions
+        if (partitions >= 2) {
+            for (const auto &[table, maxId] : rawTables) {
+                auto result = db->query("SELECT to_regclass('public." + table + "') IS NULL OR EXISTS "
+                    "(SELECT 1 FROM pg_partitioned_table WHERE partrelid = 'public." + table + "'::regclass);");
+                if (result.empty()) {
+                    return false;
+                }
+                if (!result[0][0].as<bool>()) {
+                    log_error("The %1% table exists without partitions, it can't be partitioned", table);
+                    return false;
+                }
+            }
+        }
+
+        // The loaded rows aren't checked against the primary keys until the
+        // import is finished, so they would be duplicated
+        if (bulkload) {
+            std::vector<std::string> tables;
+            boost::split(tables, bulkTables, boost::is_any_of("|"));
+            for (const auto &table : tables) {
+                auto result = db->query("SELECT to_regclass('public." + table + "') IS NOT NULL;");
+                if (result.empty()) {
+                    return false;
+                }
+                if (!result[0][0].as<bool>()) {
+                    continue;
+                }
+                result = db->query("SELECT EXISTS (SELECT 1 FROM public." + table + ");");
+                if (result.empty() || result[0][0].as<bool>()) {
+                    log_error("The %1% table isn't empty, a bulk load needs empty tables", table);
+                    return false;
+                }
+            }
+        }
+
+        // For a bulk load the tables are UNLOGGED and without primary keys,
+        // finalizeDB() adds them after the import
+        const std::string unlogged = bulkload ? "UNLOGGED " : "";
+        if (bulkload) {
+            sql = std::regex_replace(sql, primaryKey, "");
+            sql = std::regex_replace(sql, std::regex("CREATE TABLE IF NOT EXISTS public\\.(way_refs|relation_members) "),
+                                     "CREATE UNLOGGED TABLE IF NOT EXISTS public.$1 ");
+        }
+        if (partitions < 2) {
+            sql = std::regex_replace(sql, std::regex("CREATE TABLE IF NOT EXISTS public\\.(nodes|ways_poly|ways_line|relations) "),
+                                     "CREATE " + unlogged + "TABLE IF NOT EXISTS public.$1 ");
+            return createTables(sql);
+        }
+
+        // The raw tables are partitioned by osm_id range. The primary keys
+        // are added to the parent tables before there are partitions, so
+        // every partition gets its own.
+        std::string partitionsSql;
+        for (const auto &[table, maxId] : rawTables) {
+            const std::regex createTable("(CREATE TABLE IF NOT EXISTS public\\." + table + " \\([^;]*\\))");
+            sql = std::regex_replace(sql, createTable, "$1 PARTITION BY RANGE (osm_id)");
+            long step = maxId / partitions;
+            for (unsigned int i = 0; i < partitions; ++i) {
+                // Partitioned tables have no storage, only the partitions are UNLOGGED
+                partitionsSql += "CREATE " + unlogged + "TABLE IF NOT EXISTS public." + table + "_p" + std::to_string(i) +
+                    " PARTITION OF public." + table + " FOR VALUES FROM (" +
+                    (i == 0 ? "MINVALUE" : std::to_string(i * step)) + ") TO (" +
+                    (i == partitions - 1 ? "MAXVALUE" : std::to_string((i + 1) * step)) + ");\n";
+            }
+        }
+        return createTables(sql + partitionsSql);
+    }
+
+    bool
+    Bootstrap::runParallel(const std::string &what, const std::vector<std::string> &names,
+                           const std::function<void(pqxx::nontransaction &, const std::string &)> &job) {
+        std::atomic<std::size_t> done = 0;
+        std::atomic<bool> ok = true;
+        std::mutex output;
+        boost::asio::thread_pool pool(pool_size);
+        for (const auto &name : names) {
+            boost::asio::post(pool, [&, name = name] {
+                auto start = std::chrono::steady_clock::now();
+                bool finished = false;
+                db->execute(what + " " + name, [&](Pq::Lease &conn) {
+                    // CREATE INDEX CONCURRENTLY and VACUUM can't run in a transaction
+                    pqxx::nontransaction worker(*conn);
+                    job(worker, name);
+                    finished = true;
+                    return pqxx::result();
+                });
+                std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+                std::scoped_lock lock{output};
+                if (finished) {
+                    std::cout << what << " " << name << " (" << ++done << "/" << names.size() << ") done in "
+                              << elapsed.count() << " seconds" << std::endl;
+                } else {
+                    std::cout << what << " " << name << " failed, see the log" << std::endl;
+                    ok = false;
+                }
+            });
+        }
+        pool.join();
+        return ok;
     }
 
-    void
-    Bootstrap::createDBIndexes(void) {
+    bool
+    Bootstrap::createDBIndexes(bool concurrently) {
         std::string filepath = ETCDIR;
         filepath += "/setup/indexes.sql";
-        db->queryFile(filepath);
+        std::ifstream file(filepath);
+        if (!file.is_open()) {
+            log_error("Could not open SQL file: %1%", filepath);
+            return false;
+        }
+
+        // One index for every statement, without the comments
+        struct Index {
+            std::string statement;
+            std::string table;
+            std::string definition;     ///< What follows the table name
+        };
+        std::map<std::string, Index> indexes;
+        std::vector<std::string> names;
+        const std::regex createIndex("CREATE INDEX (IF NOT EXISTS )?(\\w+) ON (public\\.)?(\\w+)([^;]*)", std::regex::icase);
+        std::string sql, line;
+        while (std::getline(file, line)) {
+            if (line.rfind("--", 0) != 0) {
+                sql += line + "\n";
+            }
+        }
+        std::vector<std::string> statements;
+        boost::split(statements, sql, boost::is_any_of(";"));
+        for (const auto &text : statements) {
+            std::string statement = boost::trim_copy(text);
+            std::smatch match;
+            if (statement.empty()) {
+                continue;
+            }
+            // Anything else would be silently left out of the database
+            if (!std::regex_match(statement, match, createIndex) || indexes.count(match[2])) {
+                log_error("Unsupported statement in %1%: %2%", filepath, statement);
+                return false;
+            }
+            names.push_back(match[2]);
+            indexes[match[2]] = {statement, match[4], match[5]};
+        }
+
+        return runParallel("Index", names, [&indexes, concurrently](pqxx::nontransaction &worker, const std::string &name) {
+            const auto &index = indexes.at(name);
+            if (!concurrently) {
+                worker.exec(index.statement);
+                return;
+            }
+            auto exists = [&worker](const std::string &relation) {
+                return !worker.exec("SELECT to_regclass('public." + relation + "');")[0][0].is_null();
+            };
+            auto partitions = worker.exec("SELECT c.relname FROM pg_inherits JOIN pg_class c ON c.oid = inhrelid "
+                "WHERE inhparent = to_regclass('public." + index.table + "') ORDER BY c.relname;");
+            if (partitions.empty()) {
+                if (!exists(name)) {
+                    worker.exec("CREATE INDEX CONCURRENTLY " + name + " ON public." + index.table + index.definition + ";");
+                } else {
+                    // Also fixes an index left invalid by a failed build
+                    worker.exec("REINDEX INDEX CONCURRENTLY public." + name + ";");
+                }
+                return;
+            }
+
+            // A partitioned table can't be indexed concurrently. The index
+            // of every partition is built concurrently, and attached to an
+            // index on the parent table only, which is valid once all of
+            // them are attached.
+            if (!exists(name)) {
+                worker.exec("CREATE INDEX " + name + " ON ONLY public." + index.table + index.definition + ";");
+            }
+            for (const auto &row : partitions) {
+                auto partition = row[0].as<std::string>();
+                auto attached = worker.exec("SELECT c.relname FROM pg_inherits JOIN pg_index i ON i.indexrelid = inhrelid "
+                    "JOIN pg_class c ON c.oid = inhrelid WHERE inhparent = 'public." + name + "'::regclass "
+                    "AND i.indrelid = 'public." + partition + "'::regclass;");
+                if (!attached.empty()) {
+                    worker.exec("REINDEX INDEX CONCURRENTLY public." + attached[0][0].as<std::string>() + ";");
+                    continue;
+                }
+                // Named like the indexes PostgreSQL creates for partitions
+                std::string child = partition + "_" + name;
+                if (name.rfind(index.table + "_", 0) == 0) {
+                    child = partition + name.substr(index.table.size());
+                }
+                if (!exists(child)) {
+                    worker.exec("CREATE INDEX CONCURRENTLY " + child + " ON public." + partition + index.definition + ";");
+                } else {
+                    worker.exec("REINDEX INDEX CONCURRENTLY public." + child + ";");
+                }
+                worker.exec("ALTER INDEX public." + name + " ATTACH PARTITION public." + child + ";");
+            }
+        });
+    }
+
+    bool
+    Bootstrap::finalizeDB(void) {
+        // The reverse indexes of refs and members, filled once from the
+        // imported data instead of for every object
+        bool ok = runParallel("Reverse index", {QueryRaw::polyTable, QueryRaw::lineTable, "relations"},
+            [](pqxx::nontransaction &worker, const std::string &table) {
+                if (table == "relations") {
+                    worker.exec("INSERT INTO public." + QueryRaw::relationMembersTable + " (relation_id, member_type, member_ref) "
+                        "SELECT DISTINCT osm_id, left(m->>'type', 1), (m->>'ref')::int8 FROM public.relations, jsonb_array_elements(refs) AS m "
+                        "WHERE m->>'type' <> '';");
+                } else {
+                    worker.exec("INSERT INTO public." + QueryRaw::wayRefsTable + " (way_id, node_id) "
+                        "SELECT DISTINCT osm_id, unnest(refs) FROM public." + table + ";");
+                }
+            });
+        if (!ok) {
+            return false;
+        }
+
+        // The tables of the bulk load and their partitions are written to
+        // the WAL, other UNLOGGED tables are left as they are
+        std::vector<std::string> tables;
+        auto result = db->query("SELECT relname FROM pg_class WHERE relnamespace = 'public'::regnamespace "
+            "AND relkind = 'r' AND relpersistence = 'u' AND relname ~ '^(" + bulkTables + ")(_p[0-9]+)?$' ORDER BY relname;");
+        for (const auto &row : result) {
+            tables.push_back(row[0].as<std::string>());
+        }
+        ok = runParallel("Logged", tables, [](pqxx::nontransaction &worker, const std::string &table) {
+            worker.exec("ALTER TABLE public." + table + " SET LOGGED;");
+        });
+        if (!ok) {
+            return false;
+        }
+
+        // The primary keys in underpass.sql, added to the partitions too
+        std::string filepath = ETCDIR;
+        filepath += "/setup/underpass.sql";
+        std::string sql = readFile(filepath);
+        std::map<std::string, std::string> keys;
+        std::vector<std::string> names;
+        for (auto it = std::sregex_iterator(sql.begin(), sql.end(), primaryKey); it != std::sregex_iterator(); ++it) {
+            names.push_back((*it)[2]);
+            keys[(*it)[2]] = std::regex_replace((*it)[0].str(), std::regex("ALTER TABLE ONLY "), "ALTER TABLE ");
+        }
+        return runParallel("Primary key", names, [&keys](pqxx::nontransaction &worker, const std::string &name) {
+            if (worker.exec("SELECT to_regclass('public." + name + "');")[0][0].is_null()) {
+                worker.exec(keys.at(name));
+            }
+        });
+    }
+
+    bool
+    Bootstrap::vacuumDB(void) {
+        // Every partition of the raw tables, or the tables themselves
+        // if they aren't partitioned
+        std::vector<std::string> tables;
+        auto result = db->query("SELECT relname FROM pg_class WHERE relnamespace = 'public'::regnamespace AND relkind = 'r' "
+            "AND relname ~ '^(nodes|ways_poly|ways_line|relations|way_refs|relation_members)(_p[0-9]+)?$' ORDER BY relname;");
+        for (const auto &row : result) {
+            tables.push_back(row[0].as<std::string>());
+        }
+        return runParallel("Vacuum", tables, [](pqxx::nontransaction &worker, const std::string &table) {
+            worker.exec("VACUUM (ANALYZE) public." + table + ";");
+        });
     }
 
 }
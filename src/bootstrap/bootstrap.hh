@@ -18,6 +18,7 @@
 //     along with Underpass.  If not, see <https://www.gnu.org/licenses/>.
 //
 
+#include <functional>
 #include "raw/queryraw.hh"
 #include "underpassconfig.hh"
 
@@ -33,19 +34,54 @@ class Bootstrap {
     ///
     /// \brief start Starts bootstrapping process
     /// \param config is the Underpass config
-    /// \return void
+    /// \return false if it couldn't connect, or the import failed
     ///
-    void start(const underpassconfig::UnderpassConfig &config);
+    bool start(const underpassconfig::UnderpassConfig &config);
     boost::posix_time::ptime getLatestTimestamp(void);
-    void initializeDB(void);
-    void createDBIndexes(void);
+    ///
+    /// \brief initializeDB creates the tables
+    /// \param partitions splits the raw tables in this number of osm_id ranges,
+    ///        0 for tables without partitions
+    /// \param bulkload creates the raw tables UNLOGGED and without primary
+    ///        keys, for an import finished with finalizeDB(). The raw
+    ///        tables must not exist, or be empty.
+    /// \return false if the tables couldn't be created
+    ///
+    bool initializeDB(unsigned int partitions = 0, bool bulkload = false);
+    ///
+    /// \brief finalizeDB fills the reverse indexes, makes the tables LOGGED
+    ///        and adds the primary keys after a bulk load, in parallel
+    /// \return false if a step failed, the tables aren't ready for replication
+    ///
+    bool finalizeDB(void);
+    ///
+    /// \brief createDBIndexes builds the indexes in setup/indexes.sql in parallel,
+    ///        one connection for each index being built
+    /// \param concurrently builds them without locking the tables for writes,
+    ///        rebuilding the ones that already exist, for a live database.
+    ///        On partitioned tables every partition is indexed on its own.
+    /// \return false if an index couldn't be built
+    ///
+    bool createDBIndexes(bool concurrently = false);
+    ///
+    /// \brief vacuumDB vacuums and analyzes the raw tables after a bootstrap,
+    ///        every partition in parallel
+    /// \return false if a table couldn't be vacuumed
+    ///
+    bool vacuumDB(void);
 
     private:
       std::shared_ptr<Pq> db;
       std::shared_ptr<QueryRaw> queryraw;
+      std::size_t pool_size = 1;
 
-      bool connect(const std::string &db_url);
-      void processPBF(std::string &pbf, int page_size, int concurrency);
+      bool connect(const std::string &db_url, std::size_t pool_size = 1);
+      /// Run the SQL that creates the tables in a transaction, false if it failed
+      bool createTables(const std::string &sql);
+      /// Run a job on each name in parallel, one connection each, reporting progress
+      bool runParallel(const std::string &what, const std::vector<std::string> &names,
+                       const std::function<void(pqxx::nontransaction &, const std::string &)> &job);
+      bool processPBF(std::string &pbf, const underpassconfig::UnderpassConfig &config);
 
   };
 
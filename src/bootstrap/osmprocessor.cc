@@ -18,14 +18,14 @@
 //
 
 #include "bootstrap/osmprocessor.hh"
+#include <filesystem>
 #include <osmium/io/any_input.hpp>
 #include <osmium/util/file.hpp>
 #include <osmium/util/progress_bar.hpp>
 #include <osmium/dynamic_handler.hpp>
 #include <osmium/geom/factory.hpp>
-#include <osmium/geom/wkt.hpp>
 #include <osmium/handler/node_locations_for_ways.hpp>
-#include <osmium/index/map/flex_mem.hpp>
+#include <osmium/index/map/all.hpp>
 #include <osmium/area/assembler.hpp>
 #include <osmium/area/multipolygon_manager.hpp>
 #include <boost/date_time.hpp>
@@ -34,28 +34,58 @@
 using namespace boost::posix_time;
 using namespace boost::gregorian;
 
-using index_type = osmium::index::map::FlexMem<osmium::unsigned_object_id_type, osmium::Location>;
+using index_type = osmium::index::map::Map<osmium::unsigned_object_id_type, osmium::Location>;
 using location_handler_type = osmium::handler::NodeLocationsForWays<index_type>;
 
 namespace osmprocessor {
 
-    boost::posix_time::ptime 
+    boost::posix_time::ptime
     osmium_ts_to_ptime(osmium::Timestamp ts) {
-        std::string timestamp_iso = ts.to_iso();
+        return boost::posix_time::from_time_t(ts.seconds_since_epoch());
+    }
 
-        // Removes 'T' and 'Z'
-        timestamp_iso.pop_back();
-        std::replace(timestamp_iso.begin(), timestamp_iso.end(), 'T', ' ');
+    // Append the locations of the nodes to a boost geometry. The repeated
+    // ones are skipped when unique is true, like the osmium geometry
+    // factories do for Ways. Throws osmium::invalid_location if a node
+    // has no location.
+    template <typename T>
+    std::size_t
+    append_locations(const osmium::NodeRefList &nodes, T &geometry, bool unique) {
+        osmium::Location last;
+        std::size_t count = 0;
+        for (const auto &node : nodes) {
+            const auto &location = node.location();
+            if (unique && count > 0 && location == last) {
+                continue;
+            }
+            boost::geometry::append(geometry, point_t(location.lon(), location.lat()));
+            last = location;
+            ++count;
+        }
+        return count;
+    }
 
-        boost::posix_time::ptime timestamp = boost::posix_time::time_from_string(timestamp_iso);
-        return timestamp;
+    // The multipolygon of an area, one polygon for every outer ring
+    void
+    area_to_multipolygon(const osmium::Area &area, multipolygon_t &multipolygon) {
+        for (const auto &outer : area.outer_rings()) {
+            polygon_t polygon;
+            append_locations(outer, polygon.outer(), false);
+            for (const auto &inner : area.inner_rings(outer)) {
+                polygon.inners().emplace_back();
+                append_locations(inner, polygon.inners().back(), false);
+            }
+            multipolygon.push_back(std::move(polygon));
+        }
+        if (multipolygon.empty()) {
+            throw osmium::geometry_error{"invalid area"};
+        }
     }
 
     class RelationHandler : public osmium::relations::RelationsManager<RelationHandler, false, true, false> {
 
         public:
 
-            osmium::geom::WKTFactory<> m_factory;
             std::map<long, std::shared_ptr<osmobjects::OsmRelation>>* relations = nullptr;
             osmium::ProgressBar* progress = nullptr;
             osmium::io::Reader* reader = nullptr;
@@ -129,11 +159,15 @@ namespace osmprocessor {
             NodeWayHandler() {}
 
             std::shared_ptr<RawTasker> rawTasker;
+            std::shared_ptr<osmobjects::NodeLocations> nodelocations;
             osmium::ProgressBar* progress = nullptr;
             osmium::io::Reader* reader = nullptr;
-            osmium::geom::WKTFactory<> factory;
 
             void node(const osmium::Node& node) {
+                if (nodelocations) {
+                    nodelocations->set(node.id(), node.location().x(), node.location().y());
+                }
+
                 OsmNode osmNode(node.location().lat(), node.location().lon());
                 osmNode.id = node.id();
                 osmNode.version = node.version();
@@ -153,8 +187,9 @@ namespace osmprocessor {
             }
 
             void way(const osmium::Way& way) {
+                OsmWay osmWay;
+                bool valid = true;
                 try {
-                    OsmWay osmWay;
                     osmWay.id = way.id();
                     osmWay.version = way.version();
                     osmWay.timestamp = osmium_ts_to_ptime(way.timestamp());
@@ -162,19 +197,27 @@ namespace osmprocessor {
                         osmWay.refs.push_back(n.ref());
                     }
                     if (osmWay.isClosed()) {
-                        auto way_geom = factory.create_polygon(way);
-                        boost::geometry::read_wkt(way_geom, osmWay.polygon);
+                        osmWay.polygon.outer().reserve(way.nodes().size());
+                        if (append_locations(way.nodes(), osmWay.polygon.outer(), true) < 4) {
+                            throw osmium::geometry_error{"need at least four points for polygon"};
+                        }
                     } else {
-                        auto way_geom = factory.create_linestring(way);
-                        boost::geometry::read_wkt(way_geom, osmWay.linestring);
+                        osmWay.linestring.reserve(way.nodes().size());
+                        if (append_locations(way.nodes(), osmWay.linestring, true) < 2) {
+                            throw osmium::geometry_error{"need at least two points for linestring"};
+                        }
                     }
                     for (const osmium::Tag& t : way.tags()) {
                         osmWay.addTag(t.key(), t.value());
                     }
                     osmWay.action = osmobjects::create;
-
-                    rawTasker->apply(osmWay);
                 } catch (const std::exception &) {
+                    // Ways without a geometry are skipped
+                    valid = false;
+                }
+                // Outside of the try, a failed import must stop
+                if (valid) {
+                    rawTasker->apply(osmWay);
                 }
 
                 if (progress && reader) {
@@ -187,7 +230,6 @@ namespace osmprocessor {
     // Handler to process geometries
     class RelationGeometryHandler : public osmium::handler::Handler {
 
-            osmium::geom::WKTFactory<> m_factory;
             std::shared_ptr<RawTasker> rawTasker;
             std::map<long, std::shared_ptr<osmobjects::OsmRelation>>* relations = nullptr;
             osmium::ProgressBar* progress = nullptr;
@@ -209,23 +251,17 @@ namespace osmprocessor {
 
                     if (!area.from_way()) {
 
-                        auto osmRelation = relations->at(area.orig_id());
-
-                        auto rel_wkt = m_factory.create_multipolygon(area);
-
-                        multipolygon_t rel_multipolygon;
-                        boost::geometry::read_wkt(rel_wkt, rel_multipolygon);
-
-                        polygon_t rel_polygon;
-                        boost::geometry::convert(rel_multipolygon[0], rel_polygon);
+                        // The relation was completed by the RelationHandler on the
+                        // same Way, and it's not needed after this
+                        auto found = relations->find(area.orig_id());
+                        if (found != relations->end()) {
+                            auto osmRelation = found->second;
+                            relations->erase(found);
 
-                        std::stringstream ss;
-                        ss << std::setprecision(12) << boost::geometry::wkt(rel_polygon);
-                        std::string rel_polygon_wkt = ss.str();
+                            area_to_multipolygon(area, osmRelation->multipolygon);
 
-                        boost::geometry::read_wkt(rel_polygon_wkt, osmRelation->multipolygon);
-
-                        rawTasker->apply(*osmRelation);
+                            rawTasker->apply(*osmRelation);
+                        }
                     }
 
                 } catch (const osmium::geometry_error& e) {
@@ -243,51 +279,86 @@ namespace osmprocessor {
         this->pbf_filename = pbf_filename;
     }
 
-    void
-    OsmProcessor::nodesAndWays() {
-        osmium::io::Reader reader{pbf_filename};
-        osmium::ProgressBar progress{reader.file_size(), osmium::isatty(2)};
-        index_type index;
-        location_handler_type location_handler{index};
-        NodeWayHandler handler; 
-        handler.progress = &progress;
-        handler.reader = &reader;
-        handler.rawTasker = rawTasker;
-        osmium::apply(reader, location_handler, handler);
-        rawTasker->finish();
-        progress.done();
-    }
+    // The relations are read first, so both managers know which Ways they need.
+    // Then there is a single pass over the file, with one index of locations
+    // for the geometries of the Ways and the multipolygons of the Relations.
+    // The handlers are called in order for every object, so a Relation is in
+    // the cache when its multipolygon is assembled with the same Way.
+    //
+    // The index is any of the osmium map types. flex_mem keeps it in memory,
+    // dense_mmap_array lets the kernel page it out, and the file based ones
+    // keep it in a file, for imports bigger than the memory.
+    bool
+    OsmProcessor::process() {
+        const auto &factory = osmium::index::MapFactory<osmium::unsigned_object_id_type, osmium::Location>::instance();
+        if (!factory.has_map_type(location_index)) {
+            std::cout << "Unknown location index " << location_index << std::endl;
+            return false;
+        }
+        // Without a file, osmium would use an anonymous temporary file, and
+        // it reuses the locations already in a file
+        if (location_index.find("_file_") != std::string::npos) {
+            std::error_code error;
+            if (location_index_file.empty()) {
+                std::cout << "The location index " << location_index << " needs a file" << std::endl;
+                return false;
+            }
+            if (std::filesystem::exists(location_index_file, error) &&
+                std::filesystem::file_size(location_index_file, error) > 0) {
+                std::cout << "The location index file " << location_index_file
+                          << " isn't empty, remove it or use another one" << std::endl;
+                return false;
+            }
+        } else if (!location_index_file.empty()) {
+            std::cout << "The location index " << location_index << " doesn't use a file" << std::endl;
+            return false;
+        }
+
+        std::unique_ptr<index_type> index;
+        try {
+            if (location_index_file.empty()) {
+                index = factory.create_map(location_index);
+            } else {
+                index = factory.create_map(location_index + "," + location_index_file);
+            }
+        } catch (const std::exception &e) {
+            std::cout << "Can't create the location index " << location_index << ": " << e.what() << std::endl;
+            return false;
+        }
 
-    void
-    OsmProcessor::relations() {
         const osmium::io::File input_file{pbf_filename};
-        osmium::io::Reader reader{input_file};
-        osmium::ProgressBar progress{reader.file_size(), osmium::isatty(2)};
-        RelationHandler relationHandler(&relcache, &progress, &reader);
-        osmium::relations::read_relations(input_file, relationHandler);
-        osmium::apply(reader, relationHandler.handler());
-        osmium::memory::Buffer buffer = relationHandler.read();
-        rawTasker->finish();
-        progress.done();
-    }
-
-    void
-    OsmProcessor::relationsGeometries() {
-        index_type index;
-        location_handler_type location_handler{index};
+        RelationHandler relationHandler(&relcache, nullptr, nullptr);
         const osmium::area::Assembler::config_type assembler_config;
         osmium::area::MultipolygonManager<osmium::area::Assembler> mp_manager{assembler_config};
-        const osmium::io::File input_file{pbf_filename};
-        osmium::relations::read_relations(input_file, mp_manager);
-        osmium::io::Reader reader{pbf_filename};
+        osmium::relations::read_relations(input_file, relationHandler, mp_manager);
+
+        osmium::io::Reader reader{input_file};
         osmium::ProgressBar progress{reader.file_size(), osmium::isatty(2)};
+        location_handler_type location_handler{*index};
+        NodeWayHandler handler;
+        handler.progress = &progress;
+        handler.reader = &reader;
+        handler.rawTasker = rawTasker;
+        handler.nodelocations = nodelocations;
         osmium::handler::DynamicHandler dynamicHandler;
-        dynamicHandler.set<RelationGeometryHandler>(rawTasker, &relcache, &progress, &reader);
-        osmium::apply(reader, location_handler, mp_manager.handler([&dynamicHandler](osmium::memory::Buffer&& buffer) {
-            osmium::apply(buffer, dynamicHandler);
-        }));
-        rawTasker->finish();
+        dynamicHandler.set<RelationGeometryHandler>(rawTasker, &relcache, nullptr, nullptr);
+        try {
+            osmium::apply(reader, location_handler, handler, relationHandler.handler(),
+                mp_manager.handler([&dynamicHandler](osmium::memory::Buffer&& buffer) {
+                    osmium::apply(buffer, dynamicHandler);
+                }));
+            reader.close();
+            rawTasker->finish();
+        } catch (const std::exception &e) {
+            std::cout << "Import aborted: " << e.what() << std::endl;
+            return false;
+        }
+        if (nodelocations) {
+            nodelocations->sync();
+        }
+        relcache.clear();
         progress.done();
+        return true;
     }
 
 }
\ No newline at end of file
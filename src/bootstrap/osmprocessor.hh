@@ -19,6 +19,7 @@
 
 #include <osmium/util/file.hpp>
 #include "bootstrap/rawtasker.hh"
+#include "osm/nodelocations.hh"
 #include <osmium/io/any_input.hpp>
 
 using namespace rawtasker;
@@ -28,14 +29,22 @@ namespace osmprocessor {
     class OsmProcessor {
         public:
 
+            /// Relations waiting for their multipolygon
             std::map<long, std::shared_ptr<osmobjects::OsmRelation>> relcache;
+            /// Index of node locations seeded while reading the nodes, if any
+            std::shared_ptr<osmobjects::NodeLocations> nodelocations;
+            /// Osmium map type of the index of node locations, and its file
+            /// for the file based types
+            std::string location_index = "flex_mem";
+            std::string location_index_file;
 
             OsmProcessor(std::shared_ptr<RawTasker> rawTasker, std::string pbf_filename);
             ~OsmProcessor(void){};
 
-            void nodesAndWays();
-            void relations();
-            void relationsGeometries();
+            /// Import the nodes, ways and relations of the file in a
+            /// single pass, returns false if the index can't be created
+            /// or the objects couldn't be written
+            bool process();
 
         private:
 
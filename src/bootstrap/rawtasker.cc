@@ -26,12 +26,37 @@
 
 namespace rawtasker {
 
-    RawTasker::RawTasker(std::shared_ptr<Pq> db, std::shared_ptr<QueryRaw> queryraw, int page_size, int concurrency) {
+    RawTasker::RawTasker(std::shared_ptr<Pq> db, std::shared_ptr<QueryRaw> queryraw, int page_size, int concurrency, bool bulkload) {
         this->db = db;
         this->queryraw = queryraw;
         this->page_size = page_size;
         this->concurrency = concurrency;
         this->chunk_size = page_size * concurrency;
+        this->bulkload = bulkload;
+    }
+
+    bool
+    RawTasker::load(const RawBatch &batch) {
+        bool committed = false;
+        db->execute("bulk load", [&batch, &committed](Pq::Lease &conn) {
+            pqxx::work worker(*conn);
+            batch.load(worker);
+            worker.commit();
+            committed = true;
+            return pqxx::result();
+        });
+        if (!committed) {
+            failed = true;
+        }
+        return committed;
+    }
+
+    void
+    RawTasker::check(void) {
+        // A page missing from the database can't be loaded again later
+        if (failed) {
+            throw std::runtime_error("Couldn't load a page into the database");
+        }
     }
 
     void
@@ -73,11 +98,21 @@ namespace rawtasker {
             }
             pool.join();
             nodecache.clear();
+            check();
         }
     }
 
     void
     RawTasker::threadNodeProcess(std::vector<OsmNode*> nodes) {
+        if (bulkload) {
+            RawBatch batch;
+            for (const OsmNode* node : nodes) {
+                batch.add(*node);
+                stat_nodes++;
+            }
+            load(batch);
+            return;
+        }
         std::string queries;
         for (const OsmNode* node : nodes) {
             std::shared_ptr<std::vector<std::string>> query = queryraw->applyChange(*node);
@@ -121,11 +156,21 @@ namespace rawtasker {
             }
             pool.join();
             waycache.clear();
+            check();
         }
     }
 
     void
     RawTasker::threadWayProcess(std::vector<OsmWay*> ways) {
+        if (bulkload) {
+            RawBatch batch;
+            for (const OsmWay* way : ways) {
+                batch.add(*way);
+                stat_ways++;
+            }
+            load(batch);
+            return;
+        }
         std::string queries;
         for (const OsmWay* way : ways) {
             std::shared_ptr<std::vector<std::string>> query = queryraw->applyChange(*way);
@@ -168,11 +213,21 @@ namespace rawtasker {
             }
             pool.join();
             relcache.clear();
+            check();
         }
     }
 
     void
     RawTasker::threadRelationProcess(std::vector<OsmRelation*> rels) {
+        if (bulkload) {
+            RawBatch batch;
+            for (const OsmRelation* rel : rels) {
+                batch.add(*rel);
+                stat_rels++;
+            }
+            load(batch);
+            return;
+        }
         std::string queries;
         for (const OsmRelation* rel : rels) {
             std::shared_ptr<std::vector<std::string>> query = queryraw->applyChange(*rel);
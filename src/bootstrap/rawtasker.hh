@@ -17,7 +17,9 @@
 //     along with Underpass.  If not, see <https://www.gnu.org/licenses/>.
 //
 
+#include <atomic>
 #include "raw/queryraw.hh"
+#include "raw/rawbatch.hh"
 #include "data/pq.hh"
 
 using namespace queryraw;
@@ -27,12 +29,15 @@ namespace rawtasker {
 class RawTasker {
     public:
 
-        RawTasker(std::shared_ptr<Pq> db, std::shared_ptr<QueryRaw> queryraw, int page_size, int concurrency);
+        /// With bulkload the objects are copied into tables without
+        /// constraints, instead of inserted one by one
+        RawTasker(std::shared_ptr<Pq> db, std::shared_ptr<QueryRaw> queryraw, int page_size, int concurrency, bool bulkload = false);
         ~RawTasker(void){};
 
         void apply(OsmNode &osmNode);
         void apply(OsmWay &osmWay);
         void apply(OsmRelation &osmRelation);
+        /// Throws if a page couldn't be loaded
         void finish();
 
     private:
@@ -45,9 +50,11 @@ class RawTasker {
         int page_size;
         int concurrency;
         int chunk_size;
+        bool bulkload;
         int stat_nodes = 0;
         int stat_ways = 0;
         int stat_rels = 0;
+        std::atomic<bool> failed = false;   ///< A bulk load failed
         void checkNodes(bool finish);
         void checkWays(bool finish);
         void checkRelations(bool finish);
@@ -57,6 +64,9 @@ class RawTasker {
         void threadWayProcess(std::vector<OsmWay*> ways);
         void threadNodeProcess(std::vector<OsmNode*> nodes);
         void threadRelationProcess(std::vector<OsmRelation*> rels);
+        bool load(const RawBatch &batch);
+        /// Stop the import if a thread failed
+        void check(void);
 
 
 };
@@ -25,6 +25,7 @@
 #include "data/pq.hh"
 #include <boost/algorithm/string.hpp>
 #include <boost/algorithm/string/split.hpp>
+#include <algorithm>
 #include <iostream>
 #include <string>
 #include <vector>
@@ -51,9 +52,26 @@ Pq::dump(void)
 }
 
 bool
-Pq::isOpen() const
+Pq::isOpen()
 {
-    return static_cast<bool>(sdb) && sdb->is_open();
+    {
+        std::scoped_lock pool_lock{pqxx_mutex};
+        if (args.empty()) {
+            return false;
+        }
+        // Every connection is leased, so they are in use
+        if (idle.empty() && connections >= poolSize) {
+            return true;
+        }
+    }
+    // Leasing checks an idle connection, or reconnects
+    try {
+        Lease db(*this);
+        return db->is_open();
+    } catch (const std::exception &e) {
+        log_error("Couldn't open database connection %1%", e.what());
+        return false;
+    }
 }
 
 bool
@@ -122,83 +140,231 @@ Pq::parseURL(const std::string &dburl)
 
 
 bool
-Pq::connect(const std::string &dburl)
+Pq::connect(const std::string &dburl, std::size_t size)
 {
-    std::string args;
+    std::string connargs;
 
     if (parseURL(dburl)) {
-        args = host + " " + port + " " + dbname + " " + user + " " + passwd;
+        connargs = host + " " + port + " " + dbname + " " + user + " " + passwd;
+        // escapedString() and the JSON of the tags leave backslashes alone,
+        // which is only safe when they aren't escapes in a literal
+        connargs += " options='-c standard_conforming_strings=on'";
     } else {
         return false;
     }
 
     // log_debug(args);
     try {
-        sdb = std::make_unique<pqxx::connection>(args);
-        if (sdb->is_open()) {
-            log_debug("Opened database connection to %1%", args);
-            return true;
-        } else {
+        // The first connection is opened now, so a wrong URL fails early,
+        // the others when they are needed
+        auto db = std::make_shared<pqxx::connection>(connargs);
+        if (!db->is_open()) {
             return false;
         }
+        {
+            pqxx::nontransaction check(*db);
+            if (check.exec("SHOW standard_conforming_strings;")[0][0].as<std::string>() != "on") {
+                log_error("The database doesn't accept standard_conforming_strings=on");
+                return false;
+            }
+        }
+        log_debug("Opened database connection to %1%", connargs);
+        std::scoped_lock pool_lock{pqxx_mutex};
+        args = connargs;
+        poolSize = std::max<std::size_t>(size, 1);
+        idle.clear();
+        idle.push_back(std::make_unique<Connection>(Connection{db, {}}));
+        connections = 1;
+        return true;
     } catch (const std::exception &e) {
-        log_error("Couldn't open database connection to %1% %2%", args,
+        log_error("Couldn't open database connection to %1% %2%", connargs,
                   e.what());
         return false;
     }
 }
 
+std::unique_ptr<Pq::Connection>
+Pq::acquire(void)
+{
+    std::unique_ptr<Connection> conn;
+    {
+        std::unique_lock pool_lock{pqxx_mutex};
+        available.wait(pool_lock, [this] { return !idle.empty() || connections < poolSize; });
+        if (!idle.empty()) {
+            conn = std::move(idle.back());
+            idle.pop_back();
+        } else {
+            ++connections;
+        }
+    }
+    // Health check, the server may have closed the connection while it
+    // was idle
+    if (conn && conn->db->is_open()) {
+        return conn;
+    }
+    if (conn) {
+        log_error("Lost a database connection, reconnecting");
+    }
+    try {
+        auto db = std::make_shared<pqxx::connection>(args);
+        return std::make_unique<Connection>(Connection{db, {}});
+    } catch (...) {
+        release(nullptr, false);
+        throw;
+    }
+}
+
+void
+Pq::release(std::unique_ptr<Connection> conn, bool valid)
+{
+    {
+        std::scoped_lock pool_lock{pqxx_mutex};
+        if (conn && valid) {
+            idle.push_back(std::move(conn));
+        } else {
+            --connections;
+        }
+    }
+    available.notify_one();
+}
+
+Pq::Lease::Lease(Pq &pq) : pq(pq), conn(pq.acquire()) {}
+
+Pq::Lease::~Lease(void)
+{
+    pq.release(std::move(conn), valid);
+}
+
+void
+Pq::Lease::prepare(const std::string &name)
+{
+    if (conn->prepared.count(name)) {
+        return;
+    }
+    std::string query;
+    {
+        std::scoped_lock pool_lock{pq.pqxx_mutex};
+        query = pq.statements.at(name);
+    }
+    conn->db->prepare(name, query);
+    conn->prepared.insert(name);
+}
+
+pqxx::result
+Pq::execute(const std::string &what, const std::function<pqxx::result(Lease &)> &function)
+{
+    // A query that fails because the connection was lost is retried once,
+    // on a new connection. Queries that fail while committing throw
+    // pqxx::in_doubt_error instead, so they are never run twice.
+    for (int attempt = 0; ; ++attempt) {
+        try {
+            Lease db(*this);
+            try {
+                return function(db);
+            } catch (const pqxx::broken_connection &) {
+                db.broken();
+                throw;
+            }
+        } catch (const pqxx::broken_connection &e) {
+            if (attempt == 0) {
+                log_error("Lost the database connection, retrying: %1%", e.what());
+                continue;
+            }
+            log_error("ERROR executing %1%: %2%", what, e.what());
+        } catch (const std::exception &e) {
+            log_error("ERROR executing %1%: %2%", what, e.what());
+        }
+        // Return an empty result so higher level code can handle the error
+        return pqxx::result();
+    }
+}
+
 pqxx::result
 Pq::query(const std::string &query)
 {
-    std::scoped_lock write_lock{pqxx_mutex};
-    pqxx::work worker(*sdb);
-    pqxx::result result;
-    try {
-        result = worker.exec(query);
+    return execute("query", [&query](Lease &db) {
+        pqxx::work worker(*db);
+        auto result = worker.exec(query);
         worker.commit();
-    } catch (std::exception &e) {
-        log_error("ERROR executing query %1%", e.what());
-        // Return an empty result so higher level code can handle the error
         return result;
+    });
+}
+
+void
+Pq::prepare(const std::string &name, const std::string &query)
+{
+    std::scoped_lock pool_lock{pqxx_mutex};
+    statements[name] = query;
+}
+
+// Binary representation of an int8[], as in array_send() in PostgreSQL:
+// the header with the number of dimensions, a flag for NULL elements, the
+// element type and the size and lower bound of the dimension, followed by
+// the length and value of every element. All in network byte order.
+static std::basic_string<std::byte>
+int8Array(const std::vector<long> &ids)
+{
+    std::basic_string<std::byte> data;
+    data.reserve(20 + ids.size() * 12);
+    auto append = [&data](uint64_t value, int bytes) {
+        for (int shift = (bytes - 1) * 8; shift >= 0; shift -= 8) {
+            data.push_back(static_cast<std::byte>(value >> shift));
+        }
+    };
+    append(1, 4);               // Dimensions
+    append(0, 4);               // No NULL elements
+    append(20, 4);              // int8 type OID
+    append(ids.size(), 4);      // Size of the dimension
+    append(1, 4);               // Lower bound
+    for (const auto id : ids) {
+        append(8, 4);
+        append(static_cast<uint64_t>(id), 8);
     }
-    return result;
+    return data;
 }
 
-std::string
-Pq::escapedString(const std::string &s)
+pqxx::result
+Pq::queryIds(const std::string &name, const std::vector<long> &ids)
 {
-    return sdb->esc(s);
+    return execute("prepared statement " + name, [&name, &ids](Lease &db) {
+        db.prepare(name);
+        pqxx::work worker(*db);
+        auto result = worker.exec_prepared(name, int8Array(ids));
+        worker.commit();
+        return result;
+    });
+}
+
+pqxx::result
+Pq::queryIds(const std::string &name, const std::vector<std::vector<long>> &ids)
+{
+    return execute("prepared statement " + name, [&name, &ids](Lease &db) {
+        db.prepare(name);
+        pqxx::params params;
+        for (const auto &list : ids) {
+            params.append(int8Array(list));
+        }
+        pqxx::work worker(*db);
+        auto result = worker.exec_prepared(name, params);
+        worker.commit();
+        return result;
+    });
 }
 
 std::string
-Pq::escapedJSON(const std::string &s) {
-    std::ostringstream o;
-    for (auto c = s.cbegin(); c != s.cend(); c++) {
-        switch (*c) {
-            case '\x00': o << "\\u0000"; break;
-            case '\x01': o << " "; break;
-            case '\x02': o << " "; break;
-            case '\x03': o << " "; break;
-            case '\x04': o << " "; break;
-            case '\x05': o << " "; break;
-            case '\x06': o << " "; break;
-            case '\x07': o << " "; break;
-            case '\x08': o << " "; break;
-            case '\x09': o << " "; break;
-            case '\x0a': o << "\n"; break;
-            case '\x0b': o << " "; break;
-            case '\x0c': o << " "; break;
-            case '\x0d': o << " "; break;
-            case '\x0e': o << " "; break;
-            case '\xfe': o << " "; break;
-            case '\x1f': o << "\\u001f"; break;
-            case '\x22': o << "\""; break;
-            case '\x5c': o << "\\"; break;
-            default: o << *c;
+Pq::escapedString(const std::string &s)
+{
+    std::string escaped;
+    escaped.reserve(s.size());
+    for (char c : s) {
+        if (c == '\'') {
+            escaped += "''";
+        } else if (c != '\0') {
+            // A text value can't hold a NUL byte
+            escaped += c;
         }
     }
-    return o.str();
+    return escaped;
 }
 
 pqxx::result
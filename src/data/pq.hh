@@ -32,9 +32,15 @@
 #include "unconfig.h"
 #endif
 
+#include <condition_variable>
+#include <functional>
 #include <iostream>
+#include <map>
+#include <memory>
 #include <pqxx/pqxx>
+#include <set>
 #include <string>
+#include <string_view>
 #include <vector>
 #include <mutex>
 
@@ -46,34 +52,71 @@ namespace pq {
 
 /// \class Pq
 /// \brief This is a higher level class wrapped around libpqxx
+///
+/// Queries run on a pool of connections, so queries from different
+/// threads run concurrently on separate backends. Connections are
+/// opened when needed, up to the size of the pool.
 class Pq {
+    struct Connection;
+
   public:
     Pq();
 
     /// Connect to the Pq database
     Pq(const std::string &dbname);
-    bool connect(const std::string &args);
-
-    /// \brief isOpen, checks if the DB is open.
+    bool connect(const std::string &args, std::size_t poolSize = 1);
+
+    /// \class Lease
+    /// \brief A connection borrowed from the pool, it's returned to
+    /// the pool when the lease is destroyed
+    class Lease {
+      public:
+        Lease(Pq &pq);
+        ~Lease(void);
+        Lease(const Lease &) = delete;
+        Lease &operator=(const Lease &) = delete;
+
+        pqxx::connection &operator*(void) { return *conn->db; };
+        pqxx::connection *operator->(void) { return conn->db.get(); };
+        /// Prepare a statement added with Pq::prepare() on this connection,
+        /// if it wasn't already
+        void prepare(const std::string &name);
+        /// The connection failed, so it's closed instead of returned to the pool
+        void broken(void) { valid = false; };
+
+      private:
+        Pq &pq;
+        std::unique_ptr<Connection> conn;
+        bool valid = true;
+    };
+
+    /// \brief isOpen, checks if the pool can lease a connection to the DB.
     /// \return TRUE if the DB is open.
-    bool isOpen() const;
+    bool isOpen();
 
     /// Run query into the database
     pqxx::result query(const std::string &query);
+    /// Add a prepared statement. It's prepared on the connection the first
+    /// time it's used, so it can be added before connecting.
+    void prepare(const std::string &name, const std::string &query);
+    /// Run a prepared statement that takes an int8[] as $1. The array is
+    /// sent in binary format, so it's never parsed as text.
+    pqxx::result queryIds(const std::string &name, const std::vector<long> &ids);
+    /// Run a prepared statement that takes an int8[] for every list of
+    /// ids, as $1, $2...
+    pqxx::result queryIds(const std::string &name, const std::vector<std::vector<long>> &ids);
+    /// Run a function with a leased connection, logging errors. It's run
+    /// again on a new connection if the connection was lost.
+    pqxx::result execute(const std::string &what, const std::function<pqxx::result(Lease &)> &function);
     /// Parse the URL for the database connection
     bool parseURL(const std::string &query);
 
     /// Dump internal data for debugging
     void dump(void);
 
-    // Escape string
-    std::string escapedString(const std::string &s);
-
-    // Escape JSON
-    std::string escapedJSON(const std::string &s);
-
-    // Database connection
-    std::shared_ptr<pqxx::connection> sdb;
+    /// Escape a string for a '' literal. Every connection is opened with
+    /// standard_conforming_strings on, so only quotes are doubled
+    static std::string escapedString(const std::string &s);
 
     // Execute SQL files
     pqxx::result queryFile(const fs::path& file_path);
@@ -86,7 +129,24 @@ class Pq {
     std::string passwd;  ///< The database password
     std::string dbname;  ///< The database name
     std::mutex pqxx_mutex;
-
+    std::map<std::string, std::string> statements; ///< Prepared statements
+
+  private:
+    struct Connection {
+        std::shared_ptr<pqxx::connection> db;
+        std::set<std::string> prepared; ///< Statements prepared on this connection
+    };
+
+    std::string args;  ///< The connection string
+    std::size_t poolSize = 1;  ///< Maximum number of connections
+    std::size_t connections = 0;  ///< Open connections, idle or leased
+    std::vector<std::unique_ptr<Connection>> idle;  ///< Connections ready to be leased
+    std::condition_variable available;
+
+    /// Wait for an idle connection, or open a new one if the pool isn't full
+    std::unique_ptr<Connection> acquire(void);
+    /// Return a connection to the pool, or close it if it failed
+    void release(std::unique_ptr<Connection> conn, bool valid);
 };
 
 } // namespace pq
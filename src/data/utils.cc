@@ -1,7 +1,9 @@
+#include <algorithm>
+#include <charconv>
+#include <cstdint>
+#include <cstring>
 #include "data/utils.hh"
 #include "osm/osmobjects.hh"
-#include <boost/property_tree/ptree.hpp>
-#include <boost/property_tree/json_parser.hpp>
 
 using namespace osmobjects;
 
@@ -12,130 +14,483 @@ DataUtils::DataUtils(std::shared_ptr<Pq> db) {
     dbconn = db;
 }
 
+// Check if any of 8 characters needs escaping in a JSON string, or in an
+// SQL literal when sql is true. These are the classic bit tricks for
+// finding a byte in a word, so most of a string is checked 8 characters
+// at a time, without a branch for every character.
+static inline bool
+needsEscape(const char *data, bool sql)
+{
+    const uint64_t ones = 0x0101010101010101ULL;
+    const uint64_t highs = 0x8080808080808080ULL;
+    uint64_t word;
+    std::memcpy(&word, data, sizeof(word));
+    auto hasByte = [&](uint8_t byte) {
+        uint64_t x = word ^ (ones * byte);
+        return (x - ones) & ~x & highs;
+    };
+    // Control characters, below 0x20
+    uint64_t found = (word - ones * 0x20) & ~word & highs;
+    found |= hasByte('"') | hasByte('\\');
+    if (sql) {
+        found |= hasByte('\'');
+    }
+    return found != 0;
+}
+
+// Append a string as a quoted JSON string, in a single pass. In an SQL
+// literal single quotes are doubled too, standard_conforming_strings
+// is on so backslashes are left alone.
+static void
+appendJSONString(std::string &json, std::string_view str, bool sql)
+{
+    static const char *hexDigits = "0123456789abcdef";
+    const char *data = str.data();
+    const std::size_t size = str.size();
+    std::size_t start = 0;
+    std::size_t i = 0;
+    json.push_back('"');
+    while (i < size) {
+        if (i + 8 <= size && !needsEscape(data + i, sql)) {
+            i += 8;
+            continue;
+        }
+        const char c = data[i];
+        if (static_cast<unsigned char>(c) >= 0x20 && c != '"' && c != '\\' && !(sql && c == '\'')) {
+            ++i;
+            continue;
+        }
+        // Copy the run of characters before this one at once
+        json.append(data + start, i - start);
+        switch (c) {
+            // jsonb can't store NUL characters, they are dropped
+            case '\0': break;
+            case '"': json.append("\\\""); break;
+            case '\\': json.append("\\\\"); break;
+            case '\'': json.append("''"); break;
+            case '\n': json.append("\\n"); break;
+            case '\r': json.append("\\r"); break;
+            case '\t': json.append("\\t"); break;
+            default:
+                json.append("\\u00");
+                json.push_back(hexDigits[c >> 4]);
+                json.push_back(hexDigits[c & 0xf]);
+        }
+        start = ++i;
+    }
+    json.append(data + start, size - start);
+    json.push_back('"');
+}
+
+// Build the JSON object of the tags, empty if there are no tags
+static std::string
+tagsJSON(const TagList &tags, bool sql)
+{
+    std::string json;
+    if (tags.size() == 0) {
+        return json;
+    }
+    std::size_t size = 2;
+    for (const auto [key, value] : tags) {
+        size += key.size() + value.size() + 6;
+    }
+    json.reserve(size + size / 8);
+    json.push_back('{');
+    for (const auto [key, value] : tags) {
+        if (json.size() > 1) {
+            json.push_back(',');
+        }
+        appendJSONString(json, key, sql);
+        json.push_back(':');
+        appendJSONString(json, value, sql);
+    }
+    json.push_back('}');
+    return json;
+}
+
+// Build the JSON array of the members, empty if there are no members
+static std::string
+membersJSON(const std::pmr::vector<OsmRelationMember> &members, bool sql)
+{
+    std::string json;
+    if (members.empty()) {
+        return json;
+    }
+    json.reserve(members.size() * 48);
+    json.push_back('[');
+    for (const auto &member : members) {
+        if (json.size() > 1) {
+            json.push_back(',');
+        }
+        json.append("{\"role\":");
+        appendJSONString(json, member.role, sql);
+        json.append(",\"type\":");
+        switch (member.type) {
+            case osmobjects::osmtype_t::way:
+                json.append("\"way\""); break;
+            case osmobjects::osmtype_t::node:
+                json.append("\"node\""); break;
+            case osmobjects::osmtype_t::relation:
+                json.append("\"relation\""); break;
+            default:
+                json.append("\"\"");
+        }
+        json.append(",\"ref\":");
+        json.append(std::to_string(member.ref));
+        json.push_back('}');
+    }
+    json.push_back(']');
+    return json;
+}
+
 // Receives a dictionary of tags (key: value) and returns
 // a JSONB string for doing an insert operation into the database.
 std::string
-DataUtils::buildTagsQuery(std::map<std::string, std::string> tags) const {
-    if (tags.size() > 0) {
-        std::string tagsStr = "jsonb_build_object(";
-        int count = 0;
-        for (auto it = std::begin(tags); it != std::end(tags); ++it) {
-            ++count;
-            // PostgreSQL has an argument LIMIT for functions (100 parameters max)
-            // Because of this, when the count of key/value pairs reaches 50, 
-            // a concatenation of multiple calls to the jsonb_build_object() function 
-            // is needed.
-            if (count == 50) {
-                tagsStr.erase(tagsStr.size() - 1);
-                tagsStr += ") || jsonb_build_object(";
-                count = 0;
-            }
-            std::string tag_format = "'%s', '%s',";
-            boost::format tag_fmt(tag_format);
-            tag_fmt % dbconn->escapedString(dbconn->escapedJSON(it->first));
-            tag_fmt % dbconn->escapedString(dbconn->escapedJSON(it->second));
-            tagsStr += tag_fmt.str();
-        }
-        tagsStr.erase(tagsStr.size() - 1);
-        return tagsStr + ")";
-    } else {
+DataUtils::buildTagsQuery(const TagList &tags) const {
+    if (tags.size() == 0) {
         return "null";
     }
+    return "'" + tagsJSON(tags, true) + "'::jsonb";
 }
 
 // Receives a list of Relation members and returns
 // a JSONB string for doing an insert operation into the database.
 std::string
-DataUtils::buildMembersQuery(std::list<OsmRelationMember> members) const {
-    if (members.size() > 0) {
-        std::string membersStr = "'[";
-        for (auto mit = std::begin(members); mit != std::end(members); ++mit) {
-            membersStr += "{";
-            std::string member_format = "\"%s\": \"%s\",";
-            boost::format member_fmt(member_format);
-            member_fmt % "role";
-            member_fmt % mit->role;
-            membersStr += member_fmt.str();
-            member_fmt % "type";
-            switch(mit->type) {
-                case osmobjects::osmtype_t::way:
-                    member_fmt % "way"; break;
-                case osmobjects::osmtype_t::node:
-                    member_fmt % "node"; break;
-                case osmobjects::osmtype_t::relation:
-                    member_fmt % "relation"; break;
+DataUtils::buildMembersQuery(const std::pmr::vector<OsmRelationMember> &members) const {
+    if (members.empty()) {
+        return "null";
+    }
+    return "'" + membersJSON(members, true) + "'::jsonb";
+}
+
+std::string
+DataUtils::buildTagsJSON(const TagList &tags)
+{
+    return tagsJSON(tags, false);
+}
+
+std::string
+DataUtils::buildMembersJSON(const std::pmr::vector<OsmRelationMember> &members)
+{
+    return membersJSON(members, false);
+}
+
+namespace {
+
+/// \class JSONReader
+/// \brief Reads the flat JSON written by buildTagsJSON() and buildMembersJSON()
+///
+/// Only objects of scalars, and arrays of them, are supported, which is
+/// all the raw tables store. Strings without escapes are returned as
+/// views of the input, escaped strings are decoded into a buffer that is
+/// reused, so reading the tags of a row doesn't allocate.
+class JSONReader {
+  public:
+    JSONReader(std::string_view json) : pos(json.data()), end(json.data() + json.size()) {};
+
+    /// Skip the character if it's the next one
+    bool
+    consume(char c)
+    {
+        skipSpace();
+        if (pos < end && *pos == c) {
+            ++pos;
+            return true;
+        }
+        return false;
+    };
+
+    bool
+    atEnd(void)
+    {
+        skipSpace();
+        return pos == end;
+    };
+
+    /// Read a string, or the text of a number, true, false or null
+    bool
+    value(std::string_view &out, std::string &buffer)
+    {
+        skipSpace();
+        if (pos < end && *pos == '"') {
+            return string(out, buffer);
+        }
+        const char *start = pos;
+        while (pos < end && *pos != ',' && *pos != '}' && *pos != ']' && !isSpace(*pos)) {
+            ++pos;
+        }
+        out = std::string_view(start, pos - start);
+        return !out.empty();
+    };
+
+  private:
+    const char *pos;
+    const char *end;
+
+    static bool isSpace(char c) { return c == ' ' || c == '\n' || c == '\r' || c == '\t'; };
+
+    void
+    skipSpace(void)
+    {
+        while (pos < end && isSpace(*pos)) {
+            ++pos;
+        }
+    };
+
+    bool
+    string(std::string_view &out, std::string &buffer)
+    {
+        const char *start = ++pos;
+        while (pos < end && *pos != '"' && *pos != '\\') {
+            ++pos;
+        }
+        if (pos == end) {
+            return false;
+        }
+        if (*pos == '"') {
+            out = std::string_view(start, pos++ - start);
+            return true;
+        }
+        // There are escapes, decode the string into the buffer
+        buffer.assign(start, pos - start);
+        while (pos < end && *pos != '"') {
+            if (*pos != '\\') {
+                const char *run = pos;
+                while (pos < end && *pos != '"' && *pos != '\\') {
+                    ++pos;
+                }
+                buffer.append(run, pos - run);
+                continue;
+            }
+            if (++pos == end) {
+                return false;
+            }
+            switch (*pos++) {
+                case '"': buffer.push_back('"'); break;
+                case '\\': buffer.push_back('\\'); break;
+                case '/': buffer.push_back('/'); break;
+                case 'b': buffer.push_back('\b'); break;
+                case 'f': buffer.push_back('\f'); break;
+                case 'n': buffer.push_back('\n'); break;
+                case 'r': buffer.push_back('\r'); break;
+                case 't': buffer.push_back('\t'); break;
+                case 'u':
+                    if (!unicode(buffer)) {
+                        return false;
+                    }
+                    break;
                 default:
-                    member_fmt % "";
+                    return false;
             }
-            membersStr += member_fmt.str();
-            membersStr += "\"ref\":";
-            membersStr += std::to_string(mit->ref);
-            membersStr += "},";
         }
-        membersStr.erase(membersStr.size() - 1);
+        if (pos == end) {
+            return false;
+        }
+        ++pos;
+        out = buffer;
+        return true;
+    };
 
-        return membersStr += "]'";
-    } else {
-        return "null";
+    bool
+    hex4(unsigned &code)
+    {
+        if (end - pos < 4) {
+            return false;
+        }
+        code = 0;
+        for (int i = 0; i < 4; i++) {
+            char c = *pos++;
+            code <<= 4;
+            if (c >= '0' && c <= '9') {
+                code |= c - '0';
+            } else if (c >= 'a' && c <= 'f') {
+                code |= c - 'a' + 10;
+            } else if (c >= 'A' && c <= 'F') {
+                code |= c - 'A' + 10;
+            } else {
+                return false;
+            }
+        }
+        return true;
+    };
+
+    // Decode a \uXXXX escape as UTF-8, with the second half of a
+    // surrogate pair if there is one
+    bool
+    unicode(std::string &buffer)
+    {
+        unsigned code;
+        if (!hex4(code)) {
+            return false;
+        }
+        if (code >= 0xd800 && code < 0xdc00) {
+            unsigned low;
+            if (end - pos < 2 || pos[0] != '\\' || pos[1] != 'u') {
+                return false;
+            }
+            pos += 2;
+            if (!hex4(low) || low < 0xdc00 || low >= 0xe000) {
+                return false;
+            }
+            code = 0x10000 + ((code - 0xd800) << 10) + (low - 0xdc00);
+        } else if (code >= 0xdc00 && code < 0xe000) {
+            // A second half without the first one
+            return false;
+        }
+        if (code < 0x80) {
+            buffer.push_back(static_cast<char>(code));
+        } else if (code < 0x800) {
+            buffer.push_back(static_cast<char>(0xc0 | (code >> 6)));
+            buffer.push_back(static_cast<char>(0x80 | (code & 0x3f)));
+        } else if (code < 0x10000) {
+            buffer.push_back(static_cast<char>(0xe0 | (code >> 12)));
+            buffer.push_back(static_cast<char>(0x80 | ((code >> 6) & 0x3f)));
+            buffer.push_back(static_cast<char>(0x80 | (code & 0x3f)));
+        } else {
+            buffer.push_back(static_cast<char>(0xf0 | (code >> 18)));
+            buffer.push_back(static_cast<char>(0x80 | ((code >> 12) & 0x3f)));
+            buffer.push_back(static_cast<char>(0x80 | ((code >> 6) & 0x3f)));
+            buffer.push_back(static_cast<char>(0x80 | (code & 0x3f)));
+        }
+        return true;
+    };
+};
+
+// Add the tags of a JSON object, the tags may be half done on an error
+bool
+readTags(std::string_view json, TagList &tags)
+{
+    JSONReader reader(json);
+    if (!reader.consume('{')) {
+        return false;
+    }
+    if (reader.consume('}')) {
+        return reader.atEnd();
     }
+    std::string keyBuffer, valueBuffer;
+    do {
+        std::string_view key, value;
+        if (!reader.value(key, keyBuffer) || !reader.consume(':') ||
+            !reader.value(value, valueBuffer)) {
+            return false;
+        }
+        tags.set(key, value);
+    } while (reader.consume(','));
+    return reader.consume('}') && reader.atEnd();
 }
 
-// Parses a JSON object from a string and return a map of key/value.
-// This function is useful for parsing tags from a query result.
-std::map<std::string, std::string>
-DataUtils::parseJSONObjectStr(std::string input) const {
-    std::map<std::string, std::string> obj;
-    boost::property_tree::ptree pt;
-    try {
-        std::istringstream jsonStream(input);
-        boost::property_tree::read_json(jsonStream, pt);
-    } catch (const boost::property_tree::json_parser::json_parser_error& e) {
-        std::cerr << "Error parsing JSON: " << e.what() << std::endl;
-        return obj;
-    }
-    for (const auto& pair : pt) {
-        obj[pair.first] = pair.second.get_value<std::string>();
-    }
-    return obj;
+// Add the members of a JSON array, some may be added before an error
+bool
+readMembers(std::string_view json, std::pmr::vector<OsmRelationMember> &members)
+{
+    JSONReader reader(json);
+    if (!reader.consume('[')) {
+        return false;
+    }
+    if (reader.consume(']')) {
+        return reader.atEnd();
+    }
+    std::string keyBuffer, valueBuffer;
+    do {
+        if (!reader.consume('{')) {
+            return false;
+        }
+        OsmRelationMember member{0, osmobjects::osmtype_t::way, ""};
+        if (!reader.consume('}')) {
+            do {
+                std::string_view key, value;
+                if (!reader.value(key, keyBuffer) || !reader.consume(':') ||
+                    !reader.value(value, valueBuffer)) {
+                    return false;
+                }
+                if (key == "ref") {
+                    // Refs are numbers, but may be strings in older data,
+                    // the reader returns both without quotes
+                    auto result = std::from_chars(value.data(), value.data() + value.size(), member.ref);
+                    if (result.ec != std::errc()) {
+                        return false;
+                    }
+                } else if (key == "type") {
+                    // Members are stored with the full type name, older data may
+                    // have only the first letter
+                    if (value == "node" || value == "n") {
+                        member.type = osmobjects::osmtype_t::node;
+                    } else if (value == "relation" || value == "r") {
+                        member.type = osmobjects::osmtype_t::relation;
+                    }
+                } else if (key == "role") {
+                    member.role = value;
+                }
+            } while (reader.consume(','));
+            if (!reader.consume('}')) {
+                return false;
+            }
+        }
+        members.push_back(std::move(member));
+    } while (reader.consume(','));
+    return reader.consume(']') && reader.atEnd();
 }
 
-// Parses a JSON object from a string and return a vector of key/value maps
-// This function is useful for parsing relation members from a query result.
-std::vector<std::map<std::string, std::string>>
-DataUtils::parseJSONArrayStr(std::string input) const {
-    std::vector<std::map<std::string, std::string>> arr;
-    boost::property_tree::ptree pt;
-    try {
-        std::istringstream jsonStream(input);
-        boost::property_tree::read_json(jsonStream, pt);
-    } catch (const boost::property_tree::json_parser::json_parser_error& e) {
-        std::cerr << "Error parsing JSON: " << e.what() << std::endl;
-        return arr;
-    }
+} // namespace
 
-    for (const auto& item : pt) {
-        std::map<std::string, std::string> obj;
-        for (const auto& pair : item.second) {
-            obj[pair.first] = pair.second.get_value<std::string>();
+// Parses the JSON object of the tags of a query result, and adds
+// them to the tags. Nothing is added if the JSON isn't valid.
+bool
+DataUtils::parseTagsJSON(std::string_view json, TagList &tags)
+{
+    if (tags.empty()) {
+        if (!readTags(json, tags)) {
+            tags.clear();
+            return false;
         }
-        arr.push_back(obj);
+        return true;
+    }
+    TagList parsed;
+    if (!readTags(json, parsed)) {
+        return false;
+    }
+    for (const auto &[key, value] : parsed) {
+        tags.set(key, value);
     }
+    return true;
+}
 
-    return arr;
+// Parses the JSON array of the members of a Relation of a query result,
+// and adds them to the members. Nothing is added if the JSON isn't valid.
+bool
+DataUtils::parseMembersJSON(std::string_view json, std::pmr::vector<OsmRelationMember> &members)
+{
+    std::size_t size = members.size();
+    if (!readMembers(json, members)) {
+        members.erase(members.begin() + size, members.end());
+        return false;
+    }
+    return true;
 }
 
 // Receives a string of comma separated values and
 // returns a vector. This function is useful for
 // getting a vector of references from a query result
-std::vector<long>
-DataUtils::arrayStrToVector(std::string refs_str) const {
-    refs_str.erase(0, 1);
-    refs_str.erase(refs_str.size() - 1);
-    std::vector<long> refs;
-    std::stringstream ss(refs_str);
-    std::string token;
-    while (std::getline(ss, token, ',')) {
-        refs.push_back(std::stod(token));
+std::pmr::vector<long>
+DataUtils::arrayStrToVector(std::string_view refs_str) const {
+    std::pmr::vector<long> refs;
+    if (refs_str.size() < 2) {
+        return refs;
+    }
+    // Skip the braces, an int8[] comes back as {1,2,3}
+    const char *pos = refs_str.data() + 1;
+    const char *end = refs_str.data() + refs_str.size() - 1;
+    refs.reserve(std::count(pos, end, ',') + 1);
+    // std::from_chars() doesn't allocate and keeps the full int64
+    // precision, converting through a double doesn't
+    while (pos < end) {
+        long ref;
+        auto result = std::from_chars(pos, end, ref);
+        if (result.ec != std::errc()) {
+            break;
+        }
+        refs.push_back(ref);
+        pos = result.ptr + 1;
     }
     return refs;
 }
@@ -20,25 +20,40 @@ class DataUtils {
         // Receives a dictionary of tags (key: value) and returns
         // a JSONB string for doing an insert operation into the database.
         std::string
-        buildTagsQuery(std::map<std::string, std::string> tags) const;
+        buildTagsQuery(const TagList &tags) const;
 
         // Receives a list of Relation members and returns
         // a JSONB string for doing an insert operation into the database.
         std::string
-        buildMembersQuery(std::list<OsmRelationMember> members) const;
-
-        // Parses a JSON object from a string and return a map of key/value.
-        // This function is useful for parsing tags from a query result.
-        std::map<std::string, std::string> parseJSONObjectStr(std::string input) const;
-
-        // Parses a JSON object from a string and return a vector of key/value maps
-        // This function is useful for parsing relation members from a query result.
-        std::vector<std::map<std::string, std::string>> parseJSONArrayStr(std::string input) const;
+        buildMembersQuery(const std::pmr::vector<OsmRelationMember> &members) const;
+
+        // Receives a dictionary of tags (key: value) and returns a JSON
+        // object, or an empty string if there are no tags. This is the
+        // text written with COPY.
+        static std::string
+        buildTagsJSON(const TagList &tags);
+
+        // Receives a list of Relation members and returns a JSON array,
+        // or an empty string if there are no members.
+        static std::string
+        buildMembersJSON(const std::pmr::vector<OsmRelationMember> &members);
+
+        // Parses the JSON object of the tags of a query result, and adds
+        // them to the tags. Returns false, and adds nothing, if the JSON
+        // isn't valid.
+        static bool
+        parseTagsJSON(std::string_view json, TagList &tags);
+
+        // Parses the JSON array of the members of a Relation of a query
+        // result, and adds them to the members. Returns false, and adds
+        // nothing, if the JSON isn't valid.
+        static bool
+        parseMembersJSON(std::string_view json, std::pmr::vector<OsmRelationMember> &members);
 
         // Receives a string of comma separated values and
         // returns a vector. This function is useful for
         // getting a vector of references from a query result
-        std::vector<long> arrayStrToVector(std::string refs_str) const;
+        std::pmr::vector<long> arrayStrToVector(std::string_view refs_str) const;
 
         boost::posix_time::ptime cleanTimeStr(std::string timestampStr) const;
 
@@ -0,0 +1,195 @@
+//
+// Copyright (c) 2025 Emilio Mariscal
+//
+// This file is part of Underpass.
+//
+//     Underpass is free software: you can redistribute it and/or modify
+//     it under the terms of the GNU General Public License as published by
+//     the Free Software Foundation, either version 3 of the License, or
+//     (at your option) any later version.
+//
+//     Underpass is distributed in the hope that it will be useful,
+//     but WITHOUT ANY WARRANTY; without even the implied warranty of
+//     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//     GNU General Public License for more details.
+//
+//     You should have received a copy of the GNU General Public License
+//     along with Underpass.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#ifndef __IDMAP_HH__
+#define __IDMAP_HH__
+
+/// \file idmap.hh
+/// \brief Hash maps and sets keyed by OSM object ids
+///
+/// Open addressing tables with linear probing. The entries are kept in
+/// a vector in insertion order, and the table only holds the position
+/// of each entry, so lookups touch a single small array and iterating
+/// the entries, or getting the list of ids for a query, is a plain
+/// vector walk without duplicates.
+
+// This is generated by autoconf
+#ifdef HAVE_CONFIG_H
+#include "unconfig.h"
+#endif
+
+#include <cstdint>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+/// \namespace osmobjects
+namespace osmobjects {
+
+/// \class IdMap
+/// \brief Map of OSM ids to values
+template <typename V>
+class IdMap {
+  public:
+    typedef std::pair<long, V> value_type;
+    typedef typename std::vector<value_type>::iterator iterator;
+    typedef typename std::vector<value_type>::const_iterator const_iterator;
+
+    IdMap(void) = default;
+    IdMap(const IdMap &) = default;
+    IdMap &operator=(const IdMap &) = default;
+    /// A moved-from map is left empty, and can still be used
+    IdMap(IdMap &&other) noexcept
+        : entries(std::move(other.entries)), slots(std::move(other.slots)) {
+        other.clear();
+    };
+    IdMap &operator=(IdMap &&other) noexcept {
+        if (this != &other) {
+            entries = std::move(other.entries);
+            slots = std::move(other.slots);
+            other.clear();
+        }
+        return *this;
+    };
+
+    /// Add an entry, returns false if the id is already in the map,
+    /// which is left unchanged, like std::map::insert
+    bool insert(long id, const V &value) {
+        std::size_t slot = probe(id);
+        if (slots[slot]) {
+            return false;
+        }
+        entries.emplace_back(id, value);
+        slots[slot] = entries.size();
+        if (entries.size() * 2 > slots.size()) {
+            rehash(slots.size() * 2);
+        }
+        return true;
+    };
+    bool insert(const value_type &entry) { return insert(entry.first, entry.second); };
+
+    /// Return a pointer to the value of an id, or nullptr
+    V *find(long id) {
+        std::size_t slot = probe(id);
+        return slots[slot] ? &entries[slots[slot] - 1].second : nullptr;
+    };
+    const V *find(long id) const {
+        std::size_t slot = probe(id);
+        return slots[slot] ? &entries[slots[slot] - 1].second : nullptr;
+    };
+    std::size_t count(long id) const { return find(id) != nullptr; };
+    /// Return the value of an id, throws std::out_of_range if it's not present
+    V &at(long id) {
+        auto value = find(id);
+        if (!value) {
+            throw std::out_of_range("IdMap::at: no such id");
+        }
+        return *value;
+    };
+    const V &at(long id) const { return const_cast<IdMap *>(this)->at(id); };
+
+    std::size_t size(void) const { return entries.size(); };
+    bool empty(void) const { return entries.empty(); };
+    void reserve(std::size_t size) {
+        entries.reserve(size);
+        std::size_t capacity = slots.size();
+        while (capacity < size * 2) {
+            capacity *= 2;
+        }
+        if (capacity != slots.size()) {
+            rehash(capacity);
+        }
+    };
+    void clear(void) {
+        entries.clear();
+        slots.assign(minCapacity, 0);
+    };
+
+    iterator begin(void) { return entries.begin(); };
+    iterator end(void) { return entries.end(); };
+    const_iterator begin(void) const { return entries.begin(); };
+    const_iterator end(void) const { return entries.end(); };
+
+  private:
+    static constexpr std::size_t minCapacity = 16;
+
+    /// Return the slot holding an id, or the empty slot where it would go
+    std::size_t probe(long id) const {
+        const std::size_t mask = slots.size() - 1;
+        // Fibonacci hashing, consecutive ids end up far apart
+        std::size_t slot = (static_cast<uint64_t>(id) * 0x9E3779B97F4A7C15ULL) >> 32 & mask;
+        while (slots[slot] && entries[slots[slot] - 1].first != id) {
+            slot = (slot + 1) & mask;
+        }
+        return slot;
+    };
+    void rehash(std::size_t capacity) {
+        slots.assign(capacity, 0);
+        for (std::size_t i = 0; i < entries.size(); ++i) {
+            slots[probe(entries[i].first)] = i + 1;
+        }
+    };
+
+    std::vector<value_type> entries;
+    /// Positions of the entries plus one, 0 means empty
+    std::vector<uint32_t> slots = std::vector<uint32_t>(minCapacity, 0);
+};
+
+/// \class IdSet
+/// \brief Set of OSM ids that keeps the insertion order
+class IdSet {
+  public:
+    /// Add an id, returns false if it was already in the set
+    bool insert(long id) {
+        if (!index.insert(id, true)) {
+            return false;
+        }
+        list.push_back(id);
+        return true;
+    };
+    std::size_t count(long id) const { return index.count(id); };
+    std::size_t size(void) const { return list.size(); };
+    bool empty(void) const { return list.empty(); };
+    void reserve(std::size_t size) {
+        index.reserve(size);
+        list.reserve(size);
+    };
+    void clear(void) {
+        index.clear();
+        list.clear();
+    };
+    /// The ids, without duplicates
+    const std::vector<long> &ids(void) const { return list; };
+
+    std::vector<long>::const_iterator begin(void) const { return list.begin(); };
+    std::vector<long>::const_iterator end(void) const { return list.end(); };
+
+  private:
+    IdMap<bool> index;
+    std::vector<long> list;
+};
+
+} // namespace osmobjects
+
+#endif // EOF __IDMAP_HH__
+
+// local Variables:
+// mode: C++
+// indent-tabs-mode: nil
+// End:
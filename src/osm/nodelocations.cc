@@ -0,0 +1,232 @@
+//
+// Copyright (c) 2025 Emilio Mariscal
+//
+// This file is part of Underpass.
+//
+//     Underpass is free software: you can redistribute it and/or modify
+//     it under the terms of the GNU General Public License as published by
+//     the Free Software Foundation, either version 3 of the License, or
+//     (at your option) any later version.
+//
+//     Underpass is distributed in the hope that it will be useful,
+//     but WITHOUT ANY WARRANTY; without even the implied warranty of
+//     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//     GNU General Public License for more details.
+//
+//     You should have received a copy of the GNU General Public License
+//     along with Underpass.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+// This is generated by autoconf
+#ifdef HAVE_CONFIG_H
+#include "unconfig.h"
+#endif
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "osm/nodelocations.hh"
+#include "utils/log.hh"
+
+using namespace logger;
+
+namespace osmobjects {
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free,
+              "node location slots must be lock free");
+
+// The header takes the first page, the slots start after it
+static const std::size_t headerSize = 4096;
+static const char magic[8] = {'U', 'N', 'D', 'L', 'O', 'C', '0', '1'};
+
+struct NodeLocations::Header {
+    char magic[8];
+    int64_t maxNodeId;
+    int64_t timestamp;      ///< Seconds since the epoch
+    char database[128];     ///< Null terminated
+};
+
+// The coordinates are stored with the sign bit flipped. A slot full of
+// zeros, like the holes of a sparse file, would be a location with both
+// coordinates at INT32_MIN, which isn't valid, so it means empty.
+static inline uint64_t
+encode(int32_t lon, int32_t lat)
+{
+    return (static_cast<uint64_t>(static_cast<uint32_t>(lon) ^ 0x80000000) << 32) |
+           (static_cast<uint32_t>(lat) ^ 0x80000000);
+}
+
+static inline std::atomic<uint64_t> &
+slot(uint64_t *slots, long id)
+{
+    return reinterpret_cast<std::atomic<uint64_t> *>(slots)[id];
+}
+
+NodeLocations::~NodeLocations(void)
+{
+    close();
+}
+
+bool
+NodeLocations::open(const std::string &filespec, bool truncate)
+{
+    static_assert(sizeof(Header) <= headerSize, "node locations header too big");
+    this->filespec = filespec;
+    mapSize = headerSize + (maxNodeId + 1) * sizeof(uint64_t);
+    fd = ::open(filespec.c_str(), O_RDWR | O_CREAT | (truncate ? O_TRUNC : 0), 0644);
+    if (fd < 0) {
+        log_error("Couldn't open node locations file %1%: %2%", filespec, std::strerror(errno));
+        return false;
+    }
+    struct stat st;
+    if (fstat(fd, &st) < 0 || (static_cast<std::size_t>(st.st_size) < mapSize &&
+                               ftruncate(fd, mapSize) < 0)) {
+        log_error("Couldn't resize node locations file %1%: %2%", filespec, std::strerror(errno));
+        ::close(fd);
+        fd = -1;
+        return false;
+    }
+    void *addr = mmap(nullptr, mapSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_NORESERVE, fd, 0);
+    if (addr == MAP_FAILED) {
+        log_error("Couldn't map node locations file %1%: %2%", filespec, std::strerror(errno));
+        ::close(fd);
+        fd = -1;
+        return false;
+    }
+    // Lookups are scattered all over the file
+    madvise(addr, mapSize, MADV_RANDOM);
+    header = static_cast<Header *>(addr);
+    if (std::memcmp(header->magic, magic, sizeof(magic)) != 0) {
+        if (st.st_size != 0 && !truncate) {
+            log_error("%1% is not a node locations file", filespec);
+            close();
+            return false;
+        }
+        std::memcpy(header->magic, magic, sizeof(magic));
+        header->maxNodeId = maxNodeId;
+    } else if (header->maxNodeId != maxNodeId) {
+        log_error("Node locations file %1% is for node ids up to %2%, not %3%", filespec, header->maxNodeId, maxNodeId);
+        close();
+        return false;
+    }
+    slots = reinterpret_cast<uint64_t *>(static_cast<char *>(addr) + headerSize);
+    log_debug("Using node locations file %1%", filespec);
+    return true;
+}
+
+void
+NodeLocations::close(void)
+{
+    if (header) {
+        // Don't lose a timestamp set after the last sync
+        if (pending > header->timestamp) {
+            sync();
+        }
+        munmap(header, mapSize);
+        header = nullptr;
+        slots = nullptr;
+        pending = 0;
+    }
+    if (fd >= 0) {
+        ::close(fd);
+        fd = -1;
+    }
+}
+
+void
+NodeLocations::set(long id, int32_t lon, int32_t lat)
+{
+    if (slots && id > 0 && id <= maxNodeId) {
+        slot(slots, id).store(encode(lon, lat), std::memory_order_relaxed);
+    }
+}
+
+void
+NodeLocations::remove(long id)
+{
+    if (slots && id > 0 && id <= maxNodeId) {
+        slot(slots, id).store(0, std::memory_order_relaxed);
+    }
+}
+
+bool
+NodeLocations::get(long id, int32_t &lon, int32_t &lat) const
+{
+    if (!slots || id <= 0 || id > maxNodeId) {
+        return false;
+    }
+    uint64_t value = slot(slots, id).load(std::memory_order_relaxed);
+    if (value == 0) {
+        return false;
+    }
+    lon = static_cast<int32_t>(static_cast<uint32_t>(value >> 32) ^ 0x80000000);
+    lat = static_cast<int32_t>(static_cast<uint32_t>(value) ^ 0x80000000);
+    return true;
+}
+
+void
+NodeLocations::sync(void)
+{
+    if (!header) {
+        return;
+    }
+    // The kernel may write the pages back in any order, so the new
+    // timestamp only goes in the header once the slots are on disk.
+    // Otherwise a crash could leave a timestamp newer than the slots.
+    if (msync(header, mapSize, MS_SYNC) != 0) {
+        log_error("Couldn't sync the node locations file %1%: %2%", filespec, std::strerror(errno));
+        return;
+    }
+    if (pending > header->timestamp) {
+        header->timestamp = pending;
+        if (msync(header, headerSize, MS_SYNC) != 0) {
+            log_error("Couldn't sync the node locations file %1%: %2%", filespec, std::strerror(errno));
+        }
+    }
+}
+
+std::time_t
+NodeLocations::timestamp(void) const
+{
+    return header ? std::max(header->timestamp, pending) : 0;
+}
+
+void
+NodeLocations::setTimestamp(std::time_t timestamp)
+{
+    if (header && timestamp > pending) {
+        pending = timestamp;
+    }
+}
+
+std::string
+NodeLocations::database(void) const
+{
+    if (!header) {
+        return "";
+    }
+    return std::string(header->database, strnlen(header->database, sizeof(header->database)));
+}
+
+void
+NodeLocations::setDatabase(const std::string &database)
+{
+    if (header) {
+        std::memset(header->database, 0, sizeof(header->database));
+        std::memcpy(header->database, database.data(),
+                    std::min(database.size(), sizeof(header->database) - 1));
+    }
+}
+
+} // namespace osmobjects
+
+// local Variables:
+// mode: C++
+// indent-tabs-mode: nil
+// End:
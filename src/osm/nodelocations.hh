@@ -0,0 +1,108 @@
+//
+// Copyright (c) 2025 Emilio Mariscal
+//
+// This file is part of Underpass.
+//
+//     Underpass is free software: you can redistribute it and/or modify
+//     it under the terms of the GNU General Public License as published by
+//     the Free Software Foundation, either version 3 of the License, or
+//     (at your option) any later version.
+//
+//     Underpass is distributed in the hope that it will be useful,
+//     but WITHOUT ANY WARRANTY; without even the implied warranty of
+//     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//     GNU General Public License for more details.
+//
+//     You should have received a copy of the GNU General Public License
+//     along with Underpass.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#ifndef __NODELOCATIONS_HH__
+#define __NODELOCATIONS_HH__
+
+/// \file nodelocations.hh
+/// \brief Persistent index of node locations
+///
+/// A file with one 64 bit slot per node id, mapped into memory. The
+/// slot holds the fixed point longitude and latitude of the node, so
+/// looking up a location is a single memory read. The file is created
+/// as a sparse file, so only the pages holding nodes use disk space,
+/// which keeps it small for extracts and about 100GB for the planet.
+///
+/// The first page of the file is a header with the database the index
+/// belongs to, and the timestamp of the newest change applied to it, so
+/// an index that missed some changes isn't used.
+
+// This is generated by autoconf
+#ifdef HAVE_CONFIG_H
+#include "unconfig.h"
+#endif
+
+#include <cstdint>
+#include <ctime>
+#include <string>
+
+/// \namespace osmobjects
+namespace osmobjects {
+
+/// \class NodeLocations
+/// \brief Memory mapped array of node locations indexed by node id
+///
+/// Reads and writes of a slot are atomic, so the replicator threads can
+/// read locations while the index is being updated.
+class NodeLocations {
+  public:
+    /// Node ids up to maxNodeId can be stored
+    NodeLocations(long maxNodeId = defaultMaxNodeId) : maxNodeId(maxNodeId) {};
+    ~NodeLocations(void);
+    NodeLocations(const NodeLocations &) = delete;
+    NodeLocations &operator=(const NodeLocations &) = delete;
+
+    /// Open the index file, creating it if it doesn't exist. With
+    /// truncate, the locations already in the file are discarded.
+    bool open(const std::string &filespec, bool truncate = false);
+    void close(void);
+    bool isOpen(void) const { return slots != nullptr; };
+
+    /// Store the location of a node, in 1e-7 degrees
+    void set(long id, int32_t lon, int32_t lat);
+    /// Forget the location of a deleted node
+    void remove(long id);
+    /// Get the location of a node, returns false if it's not in the index
+    bool get(long id, int32_t &lon, int32_t &lat) const;
+    /// Write the changes to disk, and then the timestamp
+    void sync(void);
+
+    /// The timestamp of the newest change applied, 0 for a new index
+    std::time_t timestamp(void) const;
+    /// Record that the changes up to a timestamp were applied, an older
+    /// timestamp is ignored. Written to disk by sync().
+    void setTimestamp(std::time_t timestamp);
+    /// The database the index belongs to, empty for a new index
+    std::string database(void) const;
+    void setDatabase(const std::string &database);
+
+    /// Enough for the ids of the planet for years to come
+    static constexpr long defaultMaxNodeId = (1L << 34) - 1;
+
+  private:
+    struct Header;
+
+    long maxNodeId;
+    std::size_t mapSize = 0;
+    Header *header = nullptr;
+    /// Timestamp not written to the header yet, see sync()
+    std::time_t pending = 0;
+    uint64_t *slots = nullptr;
+    int fd = -1;
+    std::string filespec;
+};
+
+} // namespace osmobjects
+
+#endif // EOF __NODELOCATIONS_HH__
+
+// local Variables:
+// mode: C++
+// indent-tabs-mode: nil
+// End:
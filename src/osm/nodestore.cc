@@ -0,0 +1,147 @@
+//
+// Copyright (c) 2025 Emilio Mariscal
+//
+// This file is part of Underpass.
+//
+//     Underpass is free software: you can redistribute it and/or modify
+//     it under the terms of the GNU General Public License as published by
+//     the Free Software Foundation, either version 3 of the License, or
+//     (at your option) any later version.
+//
+//     Underpass is distributed in the hope that it will be useful,
+//     but WITHOUT ANY WARRANTY; without even the implied warranty of
+//     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//     GNU General Public License for more details.
+//
+//     You should have received a copy of the GNU General Public License
+//     along with Underpass.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+// This is generated by autoconf
+#ifdef HAVE_CONFIG_H
+#include "unconfig.h"
+#endif
+
+#include <cmath>
+#include <stdexcept>
+
+#include "osm/nodestore.hh"
+
+namespace bg = boost::geometry;
+
+namespace osmobjects {
+
+int32_t
+NodeStore::toFixed(double coord)
+{
+    return static_cast<int32_t>(std::lround(coord * precision));
+}
+
+bool
+NodeStore::insert(const OsmNode &node)
+{
+    return insert(node.id, node.point.get<0>(), node.point.get<1>(),
+                  node.version, node.changeset);
+}
+
+bool
+NodeStore::insert(long id, double lon, double lat, int version, long changeset)
+{
+    if (index.find(id)) {
+        return false;
+    }
+    append(id, lon, lat, version, changeset);
+    return true;
+}
+
+void
+NodeStore::append(long id, double lon, double lat, int version, long changeset)
+{
+    index.insert(id, ids.size());
+    ids.push_back(id);
+    lons.push_back(toFixed(lon));
+    lats.push_back(toFixed(lat));
+    versions.push_back(version);
+    changesets.push_back(changeset);
+}
+
+std::size_t
+NodeStore::find(long id) const
+{
+    auto pos = index.find(id);
+    if (!pos) {
+        return npos;
+    }
+    return *pos;
+}
+
+point_t
+NodeStore::at(long id) const
+{
+    auto pos = find(id);
+    if (pos == npos) {
+        throw std::out_of_range("NodeStore::at: no such node");
+    }
+    return point(pos);
+}
+
+void
+NodeStore::inBox(const bg::model::box<point_t> &box, std::vector<uint8_t> &mask) const
+{
+    const int32_t minLon = toFixed(box.min_corner().get<0>());
+    const int32_t minLat = toFixed(box.min_corner().get<1>());
+    const int32_t maxLon = toFixed(box.max_corner().get<0>());
+    const int32_t maxLat = toFixed(box.max_corner().get<1>());
+    const int32_t *lon = lons.data();
+    const int32_t *lat = lats.data();
+    const std::size_t n = ids.size();
+    mask.resize(n);
+    uint8_t *out = mask.data();
+    // No branches, so the compiler can vectorize this loop
+    for (std::size_t i = 0; i < n; ++i) {
+        out[i] = (lon[i] >= minLon) & (lon[i] <= maxLon) &
+                 (lat[i] >= minLat) & (lat[i] <= maxLat);
+    }
+}
+
+void
+NodeStore::within(const multipolygon_t &poly, std::vector<uint8_t> &mask) const
+{
+    bg::model::box<point_t> envelope;
+    bg::envelope(poly, envelope);
+    inBox(envelope, mask);
+    for (std::size_t i = 0; i < mask.size(); ++i) {
+        if (mask[i]) {
+            mask[i] = bg::within(point(i), poly);
+        }
+    }
+}
+
+void
+NodeStore::reserve(std::size_t size)
+{
+    ids.reserve(size);
+    lats.reserve(size);
+    lons.reserve(size);
+    versions.reserve(size);
+    changesets.reserve(size);
+    index.reserve(size);
+}
+
+void
+NodeStore::clear(void)
+{
+    ids.clear();
+    lats.clear();
+    lons.clear();
+    versions.clear();
+    changesets.clear();
+    index.clear();
+}
+
+} // namespace osmobjects
+
+// local Variables:
+// mode: C++
+// indent-tabs-mode: nil
+// End:
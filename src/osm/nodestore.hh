@@ -0,0 +1,105 @@
+//
+// Copyright (c) 2025 Emilio Mariscal
+//
+// This file is part of Underpass.
+//
+//     Underpass is free software: you can redistribute it and/or modify
+//     it under the terms of the GNU General Public License as published by
+//     the Free Software Foundation, either version 3 of the License, or
+//     (at your option) any later version.
+//
+//     Underpass is distributed in the hope that it will be useful,
+//     but WITHOUT ANY WARRANTY; without even the implied warranty of
+//     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//     GNU General Public License for more details.
+//
+//     You should have received a copy of the GNU General Public License
+//     along with Underpass.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#ifndef __NODESTORE_HH__
+#define __NODESTORE_HH__
+
+/// \file nodestore.hh
+/// \brief Columnar storage for node coordinates
+///
+/// Building geometries only needs the id and the location of the nodes,
+/// so instead of keeping full OsmNode objects around, the nodes are
+/// stored as parallel arrays. Coordinates are fixed point integers with
+/// a precision of 1e-7 degrees, the same used by OSM and osmium.
+
+// This is generated by autoconf
+#ifdef HAVE_CONFIG_H
+#include "unconfig.h"
+#endif
+
+#include <cstdint>
+#include <vector>
+
+#include "osm/osmobjects.hh"
+#include "osm/idmap.hh"
+
+/// \namespace osmobjects
+namespace osmobjects {
+
+/// \class NodeStore
+/// \brief Structure of arrays holding the nodes used to build geometries
+class NodeStore {
+  public:
+    static constexpr std::size_t npos = SIZE_MAX;
+
+    /// Convert between degrees and the fixed point representation
+    static int32_t toFixed(double coord);
+    static double toDouble(int32_t coord) { return coord / precision; };
+
+    /// Add a node, returns false if a node with the same id is already
+    /// in the store, like std::map::insert
+    bool insert(const OsmNode &node);
+    bool insert(long id, double lon, double lat, int version = 0, long changeset = 0);
+    /// Add a node at the end of the arrays, even if a node with the same
+    /// id is already in the store, so the positions follow the order of
+    /// the calls. find() returns the first node with an id.
+    void append(long id, double lon, double lat, int version = 0, long changeset = 0);
+    /// Return the position of a node in the arrays, or npos
+    std::size_t find(long id) const;
+    std::size_t count(long id) const { return find(id) != npos; };
+    /// Return the location of a node, throws std::out_of_range if it's
+    /// not present
+    point_t at(long id) const;
+    /// Return the location of the node at a position in the arrays
+    point_t point(std::size_t pos) const {
+        return point_t(toDouble(lons[pos]), toDouble(lats[pos]));
+    };
+
+    /// Set mask[i] to 1 for every node inside the box, 0 otherwise
+    void inBox(const boost::geometry::model::box<point_t> &box,
+               std::vector<uint8_t> &mask) const;
+    /// Set mask[i] to 1 for every node inside the polygon, 0 otherwise.
+    /// Nodes outside the envelope of the polygon are discarded first with
+    /// inBox(), so the full test only runs for a few candidates.
+    void within(const multipolygon_t &poly, std::vector<uint8_t> &mask) const;
+
+    std::size_t size(void) const { return ids.size(); };
+    bool empty(void) const { return ids.empty(); };
+    void reserve(std::size_t size);
+    void clear(void);
+
+    std::vector<long> ids;
+    std::vector<int32_t> lats;          ///< Latitudes, in 1e-7 degrees
+    std::vector<int32_t> lons;          ///< Longitudes, in 1e-7 degrees
+    std::vector<int32_t> versions;
+    std::vector<long> changesets;
+
+  private:
+    static constexpr double precision = 10000000.0;
+    IdMap<uint32_t> index;
+};
+
+} // namespace osmobjects
+
+#endif // EOF __NODESTORE_HH__
+
+// local Variables:
+// mode: C++
+// indent-tabs-mode: nil
+// End:
@@ -55,6 +55,7 @@ using namespace boost::gregorian;
 
 #include "osm/osmobjects.hh"
 #include "osm/osmchange.hh"
+#include "osm/nodestore.hh"
 #include <ogr_geometry.h>
 
 using namespace osmobjects;
@@ -250,15 +251,15 @@ OsmChangeFile::on_start_element(const Glib::ustring &name,
     // There are 3 change states to handle, each one contains possibly multiple
     // nodes and ways.
     if (name == "create") {
-        change = std::make_shared<OsmChange>(osmobjects::create);
+        change = std::make_shared<OsmChange>(osmobjects::create, arena);
         changes.push_back(change);
         return;
     } else if (name == "modify") {
-        change = std::make_shared<OsmChange>(osmobjects::modify);
+        change = std::make_shared<OsmChange>(osmobjects::modify, arena);
         changes.push_back(change);
         return;
     } else if (name == "delete") {
-        change = std::make_shared<OsmChange>(osmobjects::remove);
+        change = std::make_shared<OsmChange>(osmobjects::remove, arena);
         changes.push_back(change);
         return;
     } else {
@@ -273,7 +274,7 @@ OsmChangeFile::on_start_element(const Glib::ustring &name,
     } else if (name == "tag") {
         // A tag element has only has 1 attribute, and numbers are stored as
         // strings
-        change->obj->tags[attributes[0].value] = attributes[1].value;
+        change->obj->addTag(attributes[0].value.raw(), attributes[1].value.raw());
         return;
     } else if (name == "way") {
         change->obj.reset();
@@ -429,11 +430,22 @@ OsmChangeFile::areaFilter(const multipolygon_t &poly)
         bool debug = false;
 
         // Filter nodes
-        for (const auto& node : change->nodes) {
-            if (poly.empty() || bg::within(node->point, poly)) {
+        if (poly.empty()) {
+            for (const auto& node : change->nodes) {
                 node->priority = true;
-            } else {
-                node->priority = false;
+            }
+        } else if (change->nodes.size() > 0) {
+            NodeStore store;
+            store.reserve(change->nodes.size());
+            // Every version of a Node in the change is checked with its own
+            // location, so the positions in the store match the nodes
+            for (const auto& node : change->nodes) {
+                store.append(node->id, node->point.get<0>(), node->point.get<1>());
+            }
+            std::vector<uint8_t> inside;
+            store.within(poly, inside);
+            for (std::size_t i = 0; i < change->nodes.size(); ++i) {
+                change->nodes[i]->priority = inside[i];
             }
         }
 
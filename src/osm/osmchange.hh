@@ -38,6 +38,7 @@
 #include <memory>
 #include <iostream>
 #include <list>
+#include <memory_resource>
 
 //#include <pqxx/pqxx>
 #ifdef LIBXML
@@ -60,6 +61,38 @@ namespace osmchange {
 /// The object types used by an OsmChange file
 typedef enum { empty, node, way, relation, member } osmtype_t;
 
+/// \class ArenaAllocator
+/// \brief Allocator for the objects of a change file
+///
+/// The objects of a change file, their tags, the refs of the ways and
+/// the members of the relations are allocated from one monotonic
+/// buffer, and released at once with the last object of the file. The
+/// GeoBuilder caches only live while the file is processed, and a copy
+/// of an object uses the heap, so keeping one doesn't pin the file.
+/// The arena is not thread safe, objects are only created while the
+/// file is parsed.
+template <typename T>
+class ArenaAllocator {
+  public:
+    typedef T value_type;
+    ArenaAllocator(const std::shared_ptr<std::pmr::monotonic_buffer_resource> &arena) : arena(arena) {};
+    template <typename U>
+    ArenaAllocator(const ArenaAllocator<U> &other) : arena(other.arena) {};
+
+    T *allocate(std::size_t n) {
+        return static_cast<T *>(arena->allocate(n * sizeof(T), alignof(T)));
+    };
+    /// Memory is only released when the arena is destroyed
+    void deallocate(T *, std::size_t) {};
+
+    template <typename U>
+    bool operator==(const ArenaAllocator<U> &other) const { return arena == other.arena; };
+    template <typename U>
+    bool operator!=(const ArenaAllocator<U> &other) const { return arena != other.arena; };
+
+    std::shared_ptr<std::pmr::monotonic_buffer_resource> arena;
+};
+
 /// \class OsmChange
 /// \brief This contains the data for a change
 ///
@@ -68,6 +101,9 @@ typedef enum { empty, node, way, relation, member } osmtype_t;
 class OsmChange {
   public:
     OsmChange(osmobjects::action_t act) { action = act; };
+    OsmChange(osmobjects::action_t act,
+              const std::shared_ptr<std::pmr::monotonic_buffer_resource> &arena)
+        : arena(arena) { action = act; };
 
     ///< dump internal data, for debugging only
     void dump(void);
@@ -167,7 +203,7 @@ class OsmChange {
     /// Instantiate a new node
     std::shared_ptr<osmobjects::OsmNode> newNode(void)
     {
-        auto tmp = std::make_shared<osmobjects::OsmNode>();
+        auto tmp = newObject<osmobjects::OsmNode>();
         type = node;
         nodes.push_back(tmp);
         return tmp;
@@ -175,8 +211,7 @@ class OsmChange {
     /// Instantiate a new way
     std::shared_ptr<osmobjects::OsmWay> newWay(void)
     {
-        std::shared_ptr<osmobjects::OsmWay> tmp =
-            std::make_shared<osmobjects::OsmWay>();
+        auto tmp = newObject<osmobjects::OsmWay>();
         type = way;
         ways.push_back(tmp);
         return tmp;
@@ -184,8 +219,7 @@ class OsmChange {
     /// Instantiate a new relation
     std::shared_ptr<osmobjects::OsmRelation> newRelation(void)
     {
-        std::shared_ptr<osmobjects::OsmRelation> tmp =
-            std::make_shared<osmobjects::OsmRelation>();
+        auto tmp = newObject<osmobjects::OsmRelation>();
         type = relation;
         relations.push_back(tmp);
         return tmp;
@@ -194,10 +228,23 @@ class OsmChange {
     ptime final_entry;    ///< The timestamp of the last change in the file
     osmobjects::action_t action = osmobjects::none; ///< The change action
     osmtype_t type;                                 ///< The OSM object type
-    std::list<std::shared_ptr<osmobjects::OsmNode>> nodes; ///< The nodes in this change
-    std::list<std::shared_ptr<osmobjects::OsmWay>> ways; ///< The ways in this change
-    std::list<std::shared_ptr<osmobjects::OsmRelation>> relations; ///< The relations in this change
+    std::vector<std::shared_ptr<osmobjects::OsmNode>> nodes; ///< The nodes in this change
+    std::vector<std::shared_ptr<osmobjects::OsmWay>> ways; ///< The ways in this change
+    std::vector<std::shared_ptr<osmobjects::OsmRelation>> relations; ///< The relations in this change
     std::shared_ptr<osmobjects::OsmObject> obj;
+
+  private:
+    /// The arena of the file this change belongs to, if any
+    std::shared_ptr<std::pmr::monotonic_buffer_resource> arena;
+
+    template <typename T>
+    std::shared_ptr<T> newObject(void)
+    {
+        if (arena) {
+            return std::allocate_shared<T>(ArenaAllocator<T>(arena), arena.get());
+        }
+        return std::make_shared<T>();
+    };
 };
 
 /// \class OsmChangeFile
@@ -239,6 +286,10 @@ class OsmChangeFile
     /// dump internal data, for debugging only
     void dump(void);
 
+  private:
+    /// Storage for the objects of this file, see ArenaAllocator
+    std::shared_ptr<std::pmr::monotonic_buffer_resource> arena =
+        std::make_shared<std::pmr::monotonic_buffer_resource>(256 * 1024);
 };
 
 } // namespace osmchange
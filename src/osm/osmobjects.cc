@@ -78,8 +78,8 @@ OsmObject::dump(void) const
     }
     if (tags.size() > 0) {
         std::cerr << "\tTags: " << tags.size() << std::endl;
-        for (auto it = std::begin(tags); it != std::end(tags); ++it) {
-            std::cerr << "\t\t" << it->first << ":" << it->second << std::endl;
+        for (const auto [key, val] : tags) {
+            std::cerr << "\t\t" << key << ":" << val << std::endl;
         }
     }
 };
@@ -102,7 +102,7 @@ OsmWay::dump(void) const
     std::cerr << boost::geometry::wkt(polygon) << std::endl;
     if (tags.size() > 0) {
         std::cerr << "\tTags: " << tags.size() << std::endl;
-        for (auto const& [key, val] : tags)
+        for (const auto [key, val] : tags)
         {
             std::cerr << key
                     << ':'
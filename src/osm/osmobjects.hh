@@ -28,6 +28,7 @@
 #include <string>
 #include <vector>
 #include <iostream>
+#include <memory_resource>
 #include <boost/geometry.hpp>
 #include <boost/date_time.hpp>
 #include "boost/date_time/posix_time/posix_time.hpp"
@@ -36,6 +37,7 @@ using namespace boost::gregorian;
 #define BOOST_BIND_GLOBAL_PLACEHOLDERS 1
 
 #include "utils/log.hh"
+#include "osm/tags.hh"
 using namespace logger;
 
 typedef boost::geometry::model::d2::point_xy<double> point_t;
@@ -65,13 +67,25 @@ typedef enum { none, create, modify, remove, modify_geom } action_t;
 
 typedef enum { empty, node, way, relation, member } osmtype_t;
 
+/// The table a Way is stored in, when it's known. The Way tables have
+/// either a LineString or a Polygon for every Way, never both.
+enum class waytable_t { unknown, line, poly };
+
 /// \class OsmObject
 /// \brief This is the base class for the common data fields used by all OSM objects
+///
+/// The tags, the refs of a way and the members of a relation can use
+/// a memory resource, so the objects parsed from a change file keep
+/// all their storage in the arena of the file. Copies of an object
+/// always use the default resource, so they don't depend on the file.
 class OsmObject {
   public:
+    OsmObject(void) {};
+    OsmObject(std::pmr::memory_resource *resource) : tags(resource) {};
+
     /// Add a metadata tag to an OSM object
-    void addTag(const std::string &key, const std::string &value) {
-        tags[key] = value;
+    void addTag(std::string_view key, std::string_view value) {
+        tags.set(key, value);
     };
 
     void setAction(action_t act) { action = act; };
@@ -86,21 +100,20 @@ class OsmObject {
     long uid = 0;                            ///< The User ID of the mapper of this object
     std::string user;                        ///< The User name  of the mapper of this object
     long changeset = 0;                      ///< The changeset ID this object is contained in
-    std::map<std::string, std::string> tags; ///< OSM metadata tags
+    TagList tags;                            ///< OSM metadata tags
 
     bool priority = false; ///< Whether it's in the priority area
     /// Dump internal data to the terminal, only for debugging
     void dump(void) const;
-    std::string getTagValue(const std::string &key) { return tags[key] ; };
-    bool containsKey(const std::string &key) { return tags.count(key); };
-    bool containsValue(const std::string &key, const std::string &value)
+    std::string_view getTagValue(std::string_view key) const { return tags.get(key); };
+    bool containsKey(std::string_view key) const { return tags.contains(key); };
+    bool containsValue(std::string_view key, std::string_view value) const
     {
-        std::string lower = boost::algorithm::to_lower_copy(value);
-        if (tags[key].size() == 0) {
+        if (tags.get(key).size() == 0) {
             return true;
         }
-        for (auto it = tags.begin(); it != tags.end(); ++it) {
-            if (it->second == value) {
+        for (const auto [k, v] : tags) {
+            if (v == value) {
                 return true;
             }
         }
@@ -117,6 +130,7 @@ class OsmNode : public OsmObject {
     OsmNode(long nid) { id = nid; };
     point_t point; ///< The location of this node
     OsmNode(void) { type = node; };
+    OsmNode(std::pmr::memory_resource *resource) : OsmObject(resource) { type = node; };
     OsmNode(double lat, double lon)
     {
         setPoint(lat, lon);
@@ -160,11 +174,13 @@ class OsmWay : public OsmObject {
         type = way;
         refs.clear();
     };
+    OsmWay(std::pmr::memory_resource *resource) : OsmObject(resource), refs(resource) { type = way; };
 
-    std::vector<long> refs;  ///< Store all the nodes by reference ID
+    std::pmr::vector<long> refs;  ///< Store all the nodes by reference ID
     linestring_t linestring; ///< Store the node as a linestring
     polygon_t polygon;       ///< Store the nodes as a polygon
     point_t center;          ///< Store the centroid of the way
+    waytable_t stored = waytable_t::unknown; ///< The table the way is stored in
 
     /// Add a reference to a node to this way
     void addRef(long ref) { refs.push_back(ref); };
@@ -175,6 +191,21 @@ class OsmWay : public OsmObject {
     {
         return refs.size() > 3 && (refs.front() == refs.back());
     };
+    /// Whether the way may be stored in the table of the other type of
+    /// geometry, so it has to be removed from it when it's written.
+    /// New ways aren't stored yet, and ways are rarely opened or closed,
+    /// so this is only true when the stored table isn't known.
+    bool mayChangeTable(void) const
+    {
+        if (action == create) {
+            return false;
+        }
+        switch (stored) {
+            case waytable_t::line: return isClosed();
+            case waytable_t::poly: return !isClosed();
+            default: return true;
+        }
+    };
     /// Return the number of nodes in this way
     int numPoints(void) { return boost::geometry::num_points(linestring); };
 
@@ -220,16 +251,17 @@ struct OsmRelationMember {
 class OsmRelation : public OsmObject {
   public:
     OsmRelation(void) { type = relation; };
+    OsmRelation(std::pmr::memory_resource *resource) : OsmObject(resource), members(resource) { type = relation; };
 
     multilinestring_t multilinestring; ///< Store the members as a multilinestring
-    polygon_t multipolygon; ///< Store the members as a multipolygon
+    multipolygon_t multipolygon; ///< Store the members as a multipolygon
     point_t center;          ///< Store the centroid of the relation
 
     /// Add a member to this relation
     void addMember(long ref, osmtype_t _type, const std::string role) { members.push_back({ref, _type, role}); };
 
     ///< The members contained in this relation
-    std::list<OsmRelationMember> members;
+    std::pmr::vector<OsmRelationMember> members;
 
     /// Dump internal data to the terminal, only for debugging
     void dump(void) const;
@@ -237,9 +269,8 @@ class OsmRelation : public OsmObject {
     /// Relation can be composed of closed ways, resulting in a multipolygon
     bool isMultiPolygon(void) const
     {
-        return (tags.count("type") &&
-            (tags.at("type") == "multipolygon" || tags.at("type") == "boundary")
-        );
+        auto type = tags.get("type");
+        return (type == "multipolygon" || type == "boundary");
     };
 
 };
@@ -0,0 +1,260 @@
+//
+// Copyright (c) 2025 Emilio Mariscal
+//
+// This file is part of Underpass.
+//
+//     Underpass is free software: you can redistribute it and/or modify
+//     it under the terms of the GNU General Public License as published by
+//     the Free Software Foundation, either version 3 of the License, or
+//     (at your option) any later version.
+//
+//     Underpass is distributed in the hope that it will be useful,
+//     but WITHOUT ANY WARRANTY; without even the implied warranty of
+//     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//     GNU General Public License for more details.
+//
+//     You should have received a copy of the GNU General Public License
+//     along with Underpass.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+// This is generated by autoconf
+#ifdef HAVE_CONFIG_H
+#include "unconfig.h"
+#endif
+
+#include <cstring>
+#include <mutex>
+#include <stdexcept>
+
+#include "osm/tags.hh"
+
+namespace osmobjects {
+
+// Keys and values common enough to be worth having from the start,
+// so they get the smallest ids.
+static const char *commonStrings[] = {
+    "building", "highway", "name", "source", "natural", "landuse",
+    "surface", "waterway", "power", "amenity", "barrier", "type",
+    "addr:street", "addr:housenumber", "addr:city", "addr:postcode",
+    "oneway", "service", "access", "leisure", "place", "wall", "ref",
+    "layer", "height", "boundary", "admin_level", "route", "railway",
+    "multipolygon", "outer", "inner", "yes", "no", "house",
+    "residential", "track", "unclassified", "footway", "path",
+    "tertiary", "secondary", "primary", "water", "wood", "tree",
+    "driveway", "parking_aisle", "asphalt", "unpaved", "paved",
+    "tower", "pole", "line", "stream", "ditch", "farmland", "grass",
+};
+
+// Keys whose values are mostly unique, so interning them would only
+// fill the table. They are matched anywhere in the key, so they also
+// cover name:en, old_name, ref:INSEE, source:date and so on.
+static const char *uniqueValueKeys[] = {
+    "name", "addr:", "ref", "note", "description", "fixme", "FIXME",
+    "website", "url", "wiki", "phone", "email", "opening_hours", "date",
+};
+
+// Longer values are unlikely to be shared by many objects
+static const std::size_t maxInternedValue = 32;
+
+// Whether the value of a tag is worth adding to the interner
+static bool
+internValue(std::string_view key, std::string_view value)
+{
+    if (value.size() > maxInternedValue) {
+        return false;
+    }
+    for (const auto unique : uniqueValueKeys) {
+        if (key.find(unique) != std::string_view::npos) {
+            return false;
+        }
+    }
+    return true;
+}
+
+StringInterner &
+StringInterner::instance(void)
+{
+    static StringInterner interner(maxBlocks << blockBits);
+    return interner;
+}
+
+StringInterner::StringInterner(std::size_t capacity) : capacity(capacity)
+{
+    for (const auto str : commonStrings) {
+        intern(str);
+    }
+}
+
+// Copy the characters of a string into the chunk storage. Must be
+// called with the lock held.
+std::string_view
+StringInterner::store(std::string_view str)
+{
+    if (str.size() > chunkSize / 4) {
+        // Long strings get their own allocation
+        chunks.push_back(std::make_unique<char[]>(str.size()));
+        std::memcpy(chunks.back().get(), str.data(), str.size());
+        return std::string_view(chunks.back().get(), str.size());
+    }
+    if (current == nullptr || chunkUsed + str.size() > chunkSize) {
+        chunks.push_back(std::make_unique<char[]>(chunkSize));
+        current = chunks.back().get();
+        chunkUsed = 0;
+    }
+    char *dest = current + chunkUsed;
+    std::memcpy(dest, str.data(), str.size());
+    chunkUsed += str.size();
+    return std::string_view(dest, str.size());
+}
+
+uint32_t
+StringInterner::intern(std::string_view str)
+{
+    auto id = find(str);
+    if (id != npos || full()) {
+        return id;
+    }
+    std::unique_lock lock(mutex);
+    // Another thread may have added it while unlocked
+    auto it = ids.find(str);
+    if (it != ids.end()) {
+        return it->second;
+    }
+    id = count.load(std::memory_order_relaxed);
+    if (id >= capacity) {
+        return npos;
+    }
+    if ((id & blockMask) == 0) {
+        blocks[id >> blockBits] = std::make_unique<std::string_view[]>(blockMask + 1);
+    }
+    auto stored = store(str);
+    blocks[id >> blockBits][id & blockMask] = stored;
+    ids.emplace(stored, id);
+    count.store(id + 1, std::memory_order_release);
+    return id;
+}
+
+uint32_t
+StringInterner::find(std::string_view str) const
+{
+    std::shared_lock lock(mutex);
+    auto it = ids.find(str);
+    if (it != ids.end()) {
+        return it->second;
+    }
+    return npos;
+}
+
+uint32_t
+TagList::encode(std::string_view str, bool intern)
+{
+    if (intern) {
+        auto id = StringInterner::instance().intern(str);
+        if (id != StringInterner::npos) {
+            return id;
+        }
+    }
+    local.emplace_back(str);
+    return localBit | static_cast<uint32_t>(local.size() - 1);
+}
+
+void
+TagList::release(uint32_t id)
+{
+    if (!(id & localBit)) {
+        return;
+    }
+    // Keep the local strings compact, the ones after it move down
+    auto index = id & ~localBit;
+    local.erase(local.begin() + index);
+    for (auto &entry : entries) {
+        if ((entry.first & localBit) && (entry.first & ~localBit) > index) {
+            --entry.first;
+        }
+        if ((entry.second & localBit) && (entry.second & ~localBit) > index) {
+            --entry.second;
+        }
+    }
+}
+
+std::string_view
+TagList::decode(uint32_t id) const
+{
+    if (id & localBit) {
+        return local[id & ~localBit];
+    }
+    return StringInterner::instance().lookup(id);
+}
+
+std::size_t
+TagList::position(std::string_view key) const
+{
+    // Most keys are interned, so compare ids instead of strings
+    auto id = StringInterner::instance().find(key);
+    for (std::size_t i = 0; i < entries.size(); ++i) {
+        if (id != StringInterner::npos) {
+            if (entries[i].first == id) {
+                return i;
+            }
+        } else if ((entries[i].first & localBit) && decode(entries[i].first) == key) {
+            return i;
+        }
+    }
+    return npos;
+}
+
+void
+TagList::set(std::string_view key, std::string_view value)
+{
+    auto pos = position(key);
+    if (pos != npos) {
+        auto old = entries[pos].second;
+        entries[pos].second = encode(value, internValue(key, value));
+        release(old);
+    } else {
+        auto id = encode(key, true);
+        entries.emplace_back(id, encode(value, internValue(key, value)));
+    }
+}
+
+std::string_view
+TagList::get(std::string_view key) const
+{
+    auto pos = position(key);
+    if (pos == npos) {
+        return std::string_view();
+    }
+    return decode(entries[pos].second);
+}
+
+std::string_view
+TagList::at(std::string_view key) const
+{
+    auto pos = position(key);
+    if (pos == npos) {
+        throw std::out_of_range("TagList::at: no such key");
+    }
+    return decode(entries[pos].second);
+}
+
+bool
+TagList::erase(std::string_view key)
+{
+    auto pos = position(key);
+    if (pos == npos) {
+        return false;
+    }
+    auto [key_id, value_id] = entries[pos];
+    entries.erase(entries.begin() + pos);
+    // The value was added after the key, so it's released first
+    release(value_id);
+    release(key_id);
+    return true;
+}
+
+} // namespace osmobjects
+
+// local Variables:
+// mode: C++
+// indent-tabs-mode: nil
+// End:
@@ -0,0 +1,180 @@
+//
+// Copyright (c) 2025 Emilio Mariscal
+//
+// This file is part of Underpass.
+//
+//     Underpass is free software: you can redistribute it and/or modify
+//     it under the terms of the GNU General Public License as published by
+//     the Free Software Foundation, either version 3 of the License, or
+//     (at your option) any later version.
+//
+//     Underpass is distributed in the hope that it will be useful,
+//     but WITHOUT ANY WARRANTY; without even the implied warranty of
+//     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//     GNU General Public License for more details.
+//
+//     You should have received a copy of the GNU General Public License
+//     along with Underpass.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#ifndef __TAGS_HH__
+#define __TAGS_HH__
+
+/// \file tags.hh
+/// \brief Compact storage for the tags of OSM objects
+///
+/// Tag keys and values are interned into a process wide string table,
+/// so every object only stores pairs of small integer ids. Common keys
+/// like building or highway, and their values, are shared by all the
+/// objects of all the files processed.
+
+// This is generated by autoconf
+#ifdef HAVE_CONFIG_H
+#include "unconfig.h"
+#endif
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include <boost/container/small_vector.hpp>
+
+/// \namespace osmobjects
+namespace osmobjects {
+
+/// \class StringInterner
+/// \brief Thread safe table of unique strings
+///
+/// Strings are never removed, so the ids and the views returned stay
+/// valid for the lifetime of the process. The table stops growing once
+/// it reaches its capacity, so it can't exhaust the memory of a long
+/// running replicator. Once full, a miss doesn't take the lock.
+class StringInterner {
+  public:
+    static constexpr uint32_t npos = UINT32_MAX;
+
+    /// The interner shared by all the OSM objects
+    static StringInterner &instance(void);
+
+    /// Return the id of a string, adding it to the table if needed.
+    /// Returns npos if the string is not in the table and it's full.
+    uint32_t intern(std::string_view str);
+    /// Return the id of a string, or npos if it's not in the table
+    uint32_t find(std::string_view str) const;
+    /// Return the string for an id
+    std::string_view lookup(uint32_t id) const {
+        return blocks[id >> blockBits][id & blockMask];
+    };
+    /// Number of strings in the table
+    std::size_t size(void) const { return count.load(std::memory_order_acquire); };
+    /// The table reached its capacity
+    bool full(void) const { return size() >= capacity; };
+
+  private:
+    static constexpr uint32_t blockBits = 12;
+    static constexpr uint32_t blockMask = (1 << blockBits) - 1;
+    static constexpr uint32_t maxBlocks = 512;
+    static constexpr std::size_t chunkSize = 64 * 1024;
+
+    StringInterner(std::size_t capacity);
+    std::string_view store(std::string_view str);
+
+    mutable std::shared_mutex mutex;
+    std::unordered_map<std::string_view, uint32_t> ids;
+    /// Views indexed by id, allocated by blocks so they never move
+    std::array<std::unique_ptr<std::string_view[]>, maxBlocks> blocks;
+    /// Storage for the characters of the strings
+    std::vector<std::unique_ptr<char[]>> chunks;
+    char *current = nullptr;
+    std::size_t chunkUsed = 0;
+    std::atomic<uint32_t> count = 0;
+    std::size_t capacity;
+};
+
+/// \class TagList
+/// \brief The tags of an OSM object
+///
+/// A small inline vector of (key, value) id pairs. Keys are interned,
+/// and so are the short values of keys that don't usually have unique
+/// values, like building or highway. Names, addresses and the strings
+/// that don't fit in the interner are kept in the object itself. Views
+/// returned by this class are valid until the list is modified.
+///
+/// The entries that don't fit inline and the local strings come from a
+/// memory resource, the default one unless another is given. A copy of
+/// a list always uses the default resource.
+class TagList {
+  public:
+    typedef std::pair<std::string_view, std::string_view> value_type;
+
+    TagList(void) {};
+    TagList(std::pmr::memory_resource *resource)
+        : entries(entries_t::allocator_type(std::pmr::polymorphic_allocator<entry_t>(resource))),
+          local(resource) {};
+
+    class const_iterator {
+      public:
+        const_iterator(const TagList *list, std::size_t pos) : list(list), pos(pos) {};
+        value_type operator*() const { return list->entry(pos); };
+        const_iterator &operator++() { ++pos; return *this; };
+        bool operator==(const const_iterator &other) const { return pos == other.pos; };
+        bool operator!=(const const_iterator &other) const { return pos != other.pos; };
+      private:
+        const TagList *list;
+        std::size_t pos;
+    };
+
+    /// Add a tag, replacing the value if the key already exists
+    void set(std::string_view key, std::string_view value);
+    /// Return the value of a key, or an empty view if it's not present
+    std::string_view get(std::string_view key) const;
+    /// Return the value of a key, throws std::out_of_range if it's not present
+    std::string_view at(std::string_view key) const;
+    bool contains(std::string_view key) const { return position(key) != npos; };
+    std::size_t count(std::string_view key) const { return contains(key); };
+    /// Remove a tag, returns false if the key wasn't present
+    bool erase(std::string_view key);
+
+    std::size_t size(void) const { return entries.size(); };
+    bool empty(void) const { return entries.empty(); };
+    void clear(void) { entries.clear(); local.clear(); };
+
+    const_iterator begin(void) const { return const_iterator(this, 0); };
+    const_iterator end(void) const { return const_iterator(this, entries.size()); };
+
+  private:
+    typedef std::pair<uint32_t, uint32_t> entry_t;
+    typedef boost::container::small_vector<entry_t, 4, std::pmr::polymorphic_allocator<entry_t>> entries_t;
+
+    static constexpr std::size_t npos = SIZE_MAX;
+    /// Ids with this bit set are indexes into the local strings
+    static constexpr uint32_t localBit = 0x80000000;
+
+    uint32_t encode(std::string_view str, bool intern);
+    std::string_view decode(uint32_t id) const;
+    /// Remove a local string that is no longer used by any entry
+    void release(uint32_t id);
+    std::size_t position(std::string_view key) const;
+    value_type entry(std::size_t pos) const {
+        return {decode(entries[pos].first), decode(entries[pos].second)};
+    };
+
+    entries_t entries;
+    std::pmr::vector<std::pmr::string> local;
+};
+
+} // namespace osmobjects
+
+#endif // EOF __TAGS_HH__
+
+// local Variables:
+// mode: C++
+// indent-tabs-mode: nil
+// End:
@@ -26,10 +26,14 @@
 #include "unconfig.h"
 #endif
 
+#include <algorithm>
+#include <cmath>
 #include <map>
 #include <string>
 #include <iostream>
 #include <boost/timer/timer.hpp>
+#include <boost/asio/thread_pool.hpp>
+#include <boost/asio/post.hpp>
 #include <boost/format.hpp>
 #include <boost/date_time/posix_time/posix_time.hpp>
 #include <boost/lexical_cast.hpp>
@@ -42,8 +46,6 @@
 #include "raw/geobuilder.hh"
 #include "osm/osmobjects.hh"
 #include "osm/osmchange.hh"
-#include <boost/algorithm/string/join.hpp>
-#include <boost/range/adaptor/transformed.hpp>
 
 using namespace pq;
 using namespace geobuilder;
@@ -57,8 +59,11 @@ namespace bg = boost::geometry;
 /// \namespace geobuilder
 namespace geobuilder {
 
-GeoBuilder::GeoBuilder(multipolygon_t &_poly, const std::shared_ptr<QueryRaw> &queryraw) :
-    poly(_poly), queryraw(queryraw) {}
+GeoBuilder::GeoBuilder(multipolygon_t &_poly, const std::shared_ptr<QueryRaw> &queryraw,
+                       const std::shared_ptr<NodeLocations> &nodelocations,
+                       unsigned int concurrency) :
+    poly(_poly), queryraw(queryraw), nodelocations(nodelocations),
+    concurrency(std::max(concurrency, 1u)) {}
 
 GeoBuilder::~GeoBuilder() = default;
 
@@ -75,6 +80,9 @@ GeoBuilder::buildGeometries(std::shared_ptr<OsmChangeFile> &osmchanges)
     // - Ways, Relations: removed and modified  
     preProcessChanges(osmchanges);
 
+    // Get everything needed from the DB in a single query
+    fetchContext(osmchanges);
+
     // Add indirectly modified features
     addIndirectlyModifiedWays(osmchanges);
     addIndirectlyModifiedRelations(osmchanges);
@@ -84,17 +92,168 @@ GeoBuilder::buildGeometries(std::shared_ptr<OsmChangeFile> &osmchanges)
     buildWays(osmchanges);
     fillWayCache(osmchanges);
     buildRelations(osmchanges);
+    context = QueryRaw::Context();
+}
+
+// Key of a location in the index of Way ends, the fixed point coordinates
+// packed in a single number
+static long
+endpointKey(const point_t &point)
+{
+    return static_cast<long>(
+        static_cast<uint64_t>(static_cast<uint32_t>(NodeStore::toFixed(point.get<0>()))) << 32 |
+        static_cast<uint32_t>(NodeStore::toFixed(point.get<1>())));
+}
+
+// A line is a ring when it has at least 4 points and the ends are the same
+static bool
+isRing(const std::vector<point_t> &points)
+{
+    return points.size() > 3 && endpointKey(points.front()) == endpointKey(points.back());
+}
+
+// Point in ring test counting the crossings of a ray, so it works with
+// rings in any orientation
+static bool
+insideRing(const point_t &point, const std::vector<point_t> &ring)
+{
+    bool inside = false;
+    const double x = point.get<0>();
+    const double y = point.get<1>();
+    for (std::size_t i = 0, j = ring.size() - 1; i < ring.size(); j = i++) {
+        const double xi = ring[i].get<0>(), yi = ring[i].get<1>();
+        const double xj = ring[j].get<0>(), yj = ring[j].get<1>();
+        if ((yi > y) != (yj > y) && x < (xj - xi) * (y - yi) / (yj - yi) + xi) {
+            inside = !inside;
+        }
+    }
+    return inside;
+}
+
+void
+WayJoiner::add(const std::vector<point_t> &points, bool inner)
+{
+    if (points.size() < 2) {
+        return;
+    }
+    uint32_t way = ways.size();
+    ways.push_back(&points);
+    roles.push_back(inner);
+    used.push_back(false);
+    chain.push_back(none);
+    chain.push_back(none);
+    // Closed Ways are complete rings, they are not joined to other Ways
+    auto front = endpointKey(points.front());
+    auto back = endpointKey(points.back());
+    if (front != back) {
+        index(2 * way, front);
+        index(2 * way + 1, back);
+    }
+}
+
+void
+WayJoiner::index(uint32_t endpoint, long key)
+{
+    auto head = heads.find(key);
+    if (head) {
+        chain[endpoint] = *head;
+        *head = endpoint;
+    } else {
+        heads.insert(key, endpoint);
+    }
 }
 
-// Join a vector of long numbers and return a comma separated string
-std::string joinIds(const std::vector<long>& vec) {
-    using namespace boost::adaptors;
-    auto asStrings = vec | transformed([](long v) { return std::to_string(v); });
-    return boost::algorithm::join(asStrings, ",");
+uint32_t
+WayJoiner::next(const point_t &point, bool inner) const
+{
+    uint32_t found = none;
+    auto head = heads.find(endpointKey(point));
+    for (uint32_t endpoint = head ? *head : none; endpoint != none; endpoint = chain[endpoint]) {
+        if (!used[endpoint / 2] && roles[endpoint / 2] == inner && endpoint < found) {
+            found = endpoint;
+        }
+    }
+    return found;
+}
+
+void
+WayJoiner::extend(linestring_t &line, bool inner, long stop)
+{
+    while (endpointKey(line.back()) != stop) {
+        auto endpoint = next(line.back(), inner);
+        if (endpoint == none) {
+            break;
+        }
+        used[endpoint / 2] = true;
+        // The first point of the Way is the last point of the line
+        const auto &points = *ways[endpoint / 2];
+        if (endpoint % 2 == 0) {
+            line.insert(line.end(), std::next(points.begin()), points.end());
+        } else {
+            line.insert(line.end(), std::next(points.rbegin()), points.rend());
+        }
+    }
+}
+
+std::vector<RelationLine>
+WayJoiner::join(void)
+{
+    std::vector<RelationLine> lines;
+    for (uint32_t way = 0; way < ways.size(); ++way) {
+        if (used[way]) {
+            continue;
+        }
+        used[way] = true;
+        RelationLine line;
+        line.points.assign(ways[way]->begin(), ways[way]->end());
+        line.inner = roles[way];
+        if (!isRing(line.points)) {
+            // Start in the direction of the next member, so Relations with
+            // sorted members keep the same order
+            auto atFront = next(line.points.front(), line.inner);
+            auto atBack = next(line.points.back(), line.inner);
+            if (atFront != none && (atBack == none || atFront < atBack)) {
+                bg::reverse(line.points);
+            }
+            extend(line.points, line.inner, endpointKey(line.points.front()));
+            // Unsorted members may also continue the line at the front
+            if (!isRing(line.points)) {
+                linestring_t head = { line.points.front() };
+                extend(head, line.inner, endpointKey(line.points.back()));
+                line.points.insert(line.points.begin(), head.rbegin(), std::prev(head.rend()));
+            }
+        }
+        lines.push_back(std::move(line));
+    }
+    return lines;
+}
+
+// Minimum number of objects for a thread, smaller files are not worth it
+static const std::size_t minObjectsPerThread = 1000;
+
+// Call function(begin, end) for slices of [0, size) on up to concurrency
+// threads, and wait for all of them
+template <typename Function>
+static void
+parallelFor(std::size_t size, unsigned int concurrency, Function function)
+{
+    std::size_t threads = std::min<std::size_t>(concurrency, size / minObjectsPerThread);
+    if (threads <= 1) {
+        function(0, size);
+        return;
+    }
+    boost::asio::thread_pool pool(threads);
+    for (std::size_t i = 0; i < threads; ++i) {
+        std::size_t begin = size * i / threads;
+        std::size_t end = size * (i + 1) / threads;
+        boost::asio::post(pool, [&function, begin, end] { function(begin, end); });
+    }
+    pool.join();
 }
 
 void
 GeoBuilder::preProcessChanges(std::shared_ptr<OsmChangeFile> &osmchanges) {
+    NodeStore modifiedNodes;
     for (const auto& changePtr : osmchanges->changes) {
         if (!changePtr) continue;
 
@@ -106,7 +265,7 @@ GeoBuilder::preProcessChanges(std::shared_ptr<OsmChangeFile> &osmchanges) {
 
                 // Keep track of modified ways
                 if (way->action == osmobjects::modify) {
-                    modifiedWaysIds.push_back(way->id);
+                    modifiedWaysIds.insert(way->id);
                     waycache.insert(std::make_pair(way->id, way));
                 }
 
@@ -114,7 +273,7 @@ GeoBuilder::preProcessChanges(std::shared_ptr<OsmChangeFile> &osmchanges) {
                 // Nodes will be needed later when building geometries for Ways
                 for (const auto& ref : way->refs) {
                     if (!nodecache.count(ref)) {
-                        referencedNodeIds.push_back(ref);
+                        referencedNodeIds.insert(ref);
                     }
                 }
 
@@ -122,7 +281,7 @@ GeoBuilder::preProcessChanges(std::shared_ptr<OsmChangeFile> &osmchanges) {
             } else {
                 // Save removed Ways for later use. This list will be used to known
                 // which Ways will be skipped when building geometries
-                removedWays.push_back(way->id);
+                removedWays.insert(way->id);
             }
         }
 
@@ -132,10 +291,7 @@ GeoBuilder::preProcessChanges(std::shared_ptr<OsmChangeFile> &osmchanges) {
         for (const auto& node : nodes) {
             if (!node) continue;
             if (node->action == osmobjects::modify) {
-                // Get only modified nodes ids inside the priority area
-                if (poly.empty() || bg::within(node->point, poly)) {
-                    modifiedNodesIds.push_back(node->id);
-                }
+                modifiedNodes.insert(*node);
             }
         }
 
@@ -144,15 +300,102 @@ GeoBuilder::preProcessChanges(std::shared_ptr<OsmChangeFile> &osmchanges) {
         auto& relations = changePtr->relations;
         for (const auto& relation : relations) {
             if (!relation) continue;
-            removedRelations.push_back(relation->id);
+            removedRelations.insert(relation->id);
 
             // Keep track of modified relations
             if (relation->action == osmobjects::modify) {
-                modifiedRelsIds.push_back(relation->id);
+                modifiedRelsIds.insert(relation->id);
             }
 
         }
     }
+
+    // Get only modified nodes ids inside the priority area
+    if (poly.empty()) {
+        modifiedNodesIds = modifiedNodes.ids;
+    } else {
+        std::vector<uint8_t> inside;
+        modifiedNodes.within(poly, inside);
+        for (std::size_t i = 0; i < inside.size(); ++i) {
+            if (inside[i]) {
+                modifiedNodesIds.push_back(modifiedNodes.ids[i]);
+            }
+        }
+    }
+}
+
+// The ids of the change are sent to the DB at once, which returns the indirectly
+// modified Ways and Relations, the geometries of the Ways and the Nodes needed to
+// build the geometries, instead of a round trip for every step.
+void
+GeoBuilder::fetchContext(std::shared_ptr<OsmChangeFile> &osmchanges) {
+    QueryRaw::ContextIds ids;
+
+    // The Nodes in the change and the ones in the local index aren't requested
+    for (const auto& change : osmchanges->changes) {
+        for (const auto& node : change->nodes) {
+            nodecache.insert(*node);
+        }
+    }
+    int32_t lon, lat;
+    for (const auto& id : referencedNodeIds) {
+        if (nodecache.count(id)) {
+            continue;
+        }
+        if (nodelocations && nodelocations->get(id, lon, lat)) {
+            nodecache.insert(id, NodeStore::toDouble(lon), NodeStore::toDouble(lat));
+        } else {
+            ids.nodes.push_back(id);
+        }
+    }
+    // With a local index, the Nodes of the indirectly modified Ways are
+    // looked up there first
+    ids.refNodes = !nodelocations;
+
+    ids.modifiedNodes = modifiedNodesIds;
+    ids.modifiedWays = modifiedWaysIds.ids();
+    ids.skipWays = ids.modifiedWays;
+    ids.skipWays.insert(ids.skipWays.end(), removedWays.begin(), removedWays.end());
+    ids.skipRelations = modifiedRelsIds.ids();
+    ids.skipRelations.insert(ids.skipRelations.end(), removedRelations.begin(), removedRelations.end());
+
+    // Ways referenced by Relations of the change, for their geometries
+    IdSet memberWays;
+    for (const auto& change : osmchanges->changes) {
+        for (const auto& relation : change->relations) {
+            if (relation->action == osmobjects::remove) {
+                continue;
+            }
+            for (const auto& member : relation->members) {
+                if (member.type == osmobjects::way) {
+                    memberWays.insert(member.ref);
+                }
+            }
+        }
+    }
+    ids.memberWays = memberWays.ids();
+
+    context = queryraw->getContext(ids);
+
+    // The geometries of the modified Ways say which table they are stored
+    // in, so they aren't removed from the other one when they are written
+    IdMap<waytable_t> tables;
+    for (const auto& way : context.geometries) {
+        if (!tables.insert(way->id, way->stored)) {
+            // Stored in both tables, the extra row has to be removed
+            *tables.find(way->id) = waytable_t::unknown;
+        }
+    }
+    for (const auto& change : osmchanges->changes) {
+        for (const auto& way : change->ways) {
+            if (way->action != osmobjects::modify) {
+                continue;
+            }
+            if (auto table = tables.find(way->id)) {
+                way->stored = *table;
+            }
+        }
+    }
 }
 
 // Incomplete geometries happens all the time on Ways and Relations because the data for
@@ -172,23 +415,23 @@ GeoBuilder::addIndirectlyModifiedWays(std::shared_ptr<OsmChangeFile> &osmchanges
 
     if (modifiedNodesIds.size() > 0) {
 
-        // Get all Ways that have at least one reference to one of the modified Nodes
-        auto indirectlyModifiedWays = queryraw->getWaysByNodesRefs(joinIds(modifiedNodesIds));
+        // All Ways that have at least one reference to one of the modified Nodes
+        // come with the context
 
         // Add a new change for the indirectly modified Way
         auto change = std::make_shared<OsmChange>(none);
-        for (const auto& way : indirectlyModifiedWays) {
+        for (const auto& way : context.ways) {
            // If the Way wasn't removed or modified
            if (
-                std::find(removedWays.begin(), removedWays.end(), way->id) == removedWays.end() &&
-                std::find(modifiedWaysIds.begin(), modifiedWaysIds.end(), way->id) == modifiedWaysIds.end()
+                !removedWays.count(way->id) &&
+                !modifiedWaysIds.count(way->id)
             ) {
 
                 // Save referenced Nodes. This list will be used for getting the geometries of
                 // these Nodes, used when building the Way geometry
                 for (const auto& ref : way->refs) {
                     if (!nodecache.count(ref)) {
-                        referencedNodeIds.push_back(ref);
+                        referencedNodeIds.insert(ref);
                     }
                 }
 
@@ -201,7 +444,7 @@ GeoBuilder::addIndirectlyModifiedWays(std::shared_ptr<OsmChangeFile> &osmchanges
 
                 // Save the id of the indirectly modified Way for later use. This will be used
                 // for identifying which Relations were indirectly modified by this change.
-                modifiedWaysIds.push_back(way->id);
+                modifiedWaysIds.insert(way->id);
            }
         }
         osmchanges->changes.push_back(change);
@@ -214,17 +457,16 @@ GeoBuilder::addIndirectlyModifiedRelations(std::shared_ptr<OsmChangeFile> &osmch
     // in a Relation was modified (or indirectly modified by a change on one of its Nodes)
     if (modifiedWaysIds.size() > 0) {
 
-        // Get indirectly modified Relations from the DB, using the list of Ways
-        // that were modified
-        auto indirectlyModifiedRelations = queryraw->getRelationsByWaysRefs(joinIds(modifiedWaysIds));
+        // Indirectly modified Relations come with the context, they were found
+        // using the list of Ways that were modified
 
         // Create a new change for the indirecty modified Relation
         auto change = std::make_shared<OsmChange>(none);
-        for (const auto& relation : indirectlyModifiedRelations) {
+        for (const auto& relation : context.relations) {
            // If the Relation // wasn't removed or modified
            if (
-                std::find(removedRelations.begin(), removedRelations.end(), relation->id) == removedRelations.end() &&
-                std::find(modifiedRelsIds.begin(), modifiedRelsIds.end(), relation->id) == modifiedRelsIds.end()
+                !removedRelations.count(relation->id) &&
+                !modifiedRelsIds.count(relation->id)
             ) {
                 // Flag it as modified geometry. This means that only the geometry was modified,
                 // nor its tags, version, etc.
@@ -241,47 +483,65 @@ GeoBuilder::addIndirectlyModifiedRelations(std::shared_ptr<OsmChangeFile> &osmch
 void
 GeoBuilder::fillNodeCache(std::shared_ptr<OsmChangeFile> &osmchanges) {
 
-    // Fill node cache with nodes in osmchanges
-    for (const auto& change : osmchanges->changes) {
-        for (const auto& node : change->nodes) {
-            nodecache.insert(std::make_pair(node->id, node));
-        }
+    // Fill nodecache with referenced Nodes from the context. This will be used
+    // later when building the geometries of Ways
+    for (const auto& node : context.nodes) {
+        nodecache.insert(*node);
     }
 
-    // Fill nodecache with referenced Nodes. This will be used later when building the
-    // geometries of Ways
-    if (referencedNodeIds.size() > 0) {
-        // Get Nodes geometries
-        auto result = queryraw->getNodesByIds(joinIds(referencedNodeIds));
-        // Fill nodecache
-        for (const auto& node : result) {
-            nodecache.insert(std::make_pair(node->id, node));
-         }
+    // The Nodes of the indirectly modified Ways weren't in the context if
+    // there is a local index. Look first there, only the Nodes that are not
+    // there are requested to the DB
+    if (nodelocations && referencedNodeIds.size() > 0) {
+        std::vector<long> missing;
+        int32_t lon, lat;
+        for (const auto& id : referencedNodeIds) {
+            if (nodecache.count(id)) {
+                continue;
+            }
+            if (nodelocations->get(id, lon, lat)) {
+                nodecache.insert(id, NodeStore::toDouble(lon), NodeStore::toDouble(lat));
+            } else {
+                missing.push_back(id);
+            }
+        }
+        if (missing.size() > 0) {
+            for (const auto& node : queryraw->getNodesByIds(missing)) {
+                nodecache.insert(*node);
+            }
+        }
     }
 }
 
 void
 GeoBuilder::fillWayCache(std::shared_ptr<OsmChangeFile> &osmchanges) {
-    if (modifiedWaysIds.size() > 0) {
-        // Get geometries for all modified Ways
-        auto ways = queryraw->getWaysByIds(joinIds(modifiedWaysIds));
-        for (const auto& w : ways) {
-            waycache.insert(std::make_pair(w->id, w));
-        }
+    // Geometries of all modified Ways and of the members of the Relations,
+    // the ones built from the change are already in the cache
+    for (const auto& w : context.geometries) {
+        waycache.insert(std::make_pair(w->id, w));
     }
 }
 
 void
 GeoBuilder::buildWays(std::shared_ptr<OsmChangeFile> &osmchanges) {
-     // Build Ways geometries using nodecache
+    std::vector<std::shared_ptr<OsmWay>> ways;
     for (const auto& change : osmchanges->changes) {
-        for (const auto& way : change->ways) {
+        ways.insert(ways.end(), change->ways.begin(), change->ways.end());
+    }
+
+    // Build Ways geometries using nodecache. Every thread only writes the
+    // geometries of its own Ways, the caches are only read.
+    std::vector<uint8_t> inside(ways.size());
+    parallelFor(ways.size(), concurrency, [&](std::size_t begin, std::size_t end) {
+        for (std::size_t i = begin; i < end; ++i) {
+            const auto& way = ways[i];
             // Only build geometries for Ways with incomplete geometries
             if (bg::num_points(way->linestring) != way->refs.size()) {
                 way->linestring.clear();
                 for (const auto& ref : way->refs) {
-                    if (nodecache.count(ref)) {
-                        bg::append(way->linestring, nodecache.at(ref)->point);
+                    auto pos = nodecache.find(ref);
+                    if (pos != NodeStore::npos) {
+                        bg::append(way->linestring, nodecache.point(pos));
                     }
                 }
                 if (way->isClosed()) {
@@ -289,329 +549,131 @@ GeoBuilder::buildWays(std::shared_ptr<OsmChangeFile> &osmchanges) {
                     way->linestring.clear();
                 }
             }
-
-            // Save Way pointer for later use. This will be used when building Relations geometries.
-            if (
-                poly.empty() ||
+            inside[i] = poly.empty() ||
                 (!way->isClosed() && bg::within(way->linestring, poly)) ||
-                (way->isClosed() && bg::within(way->polygon.outer(), poly))
-            ) {
-                if (waycache.count(way->id)) {
-                    if (way->isClosed()) {
-                        waycache.at(way->id)->polygon = way->polygon;
-                    } else {
-                        waycache.at(way->id)->linestring = way->linestring;
-                    }
-                } else {
-                    waycache.insert(std::make_pair(way->id, way));
-                }
-            }
+                (way->isClosed() && bg::within(way->polygon.outer(), poly));
+        }
+    });
 
+    // Save Way pointer for later use. This will be used when building Relations
+    // geometries. This is done in file order, so later versions of a Way win.
+    for (std::size_t i = 0; i < ways.size(); ++i) {
+        if (!inside[i]) {
+            continue;
+        }
+        const auto& way = ways[i];
+        auto cached = waycache.find(way->id);
+        if (cached) {
+            if (way->isClosed()) {
+                (*cached)->polygon = way->polygon;
+            } else {
+                (*cached)->linestring = way->linestring;
+            }
+        } else {
+            waycache.insert(way->id, way);
         }
     }
 }
 
 void
 GeoBuilder::buildRelations(std::shared_ptr<OsmChangeFile> &osmchanges) {
-    // Build list of Relations that have missing geometries. This list will be used for
-    // querying the database and get the geometries of the referenced Ways .
-    std::vector<long> relsForWayCacheIds;
+    // The geometries of the referenced Ways came with the context, and are
+    // in the way cache already
+    std::vector<OsmRelation *> relations;
     for (const auto& change : osmchanges->changes) {
         for (const auto& relation : change->relations) {
+            // Skip removed relations
             if (relation->action != osmobjects::remove) {
-                for (const auto& member : relation->members) {
-                    if (member.type == osmobjects::way && !waycache.count(member.ref)) {
-                        relsForWayCacheIds.push_back(member.ref);
-                    }
-                }
+                relations.push_back(relation.get());
             }
         }
     }
 
-    // Get the geometries of the referenced Ways from the DB.
-    if (relsForWayCacheIds.size() > 0) {
-        auto ways = queryraw->getWaysByIds(joinIds(relsForWayCacheIds));
-        for (const auto& w : ways) {
-            waycache.insert(std::make_pair(w->id, w));
+    // Build geometries for Relations (Polygon or MultiLinestring). The way
+    // cache is complete now, and it's only read from here on.
+    parallelFor(relations.size(), concurrency, [&](std::size_t begin, std::size_t end) {
+        for (std::size_t i = begin; i < end; ++i) {
+            buildRelationGeometry(*relations[i]);
         }
-    }
-
-    // Build geometries for Relations (Polygon or MultiLinestring)
-    for (const auto& change : osmchanges->changes) {
-        for (const auto& relation : change->relations) {
-            // Skip removed relations
-            if (relation->action != osmobjects::remove) {
-                buildRelationGeometry(*relation);
-            }
-        }
-    }
+    });
 }
 
 void
 GeoBuilder::buildRelationGeometry(osmobjects::OsmRelation &relation) {
-
-    std::vector<RelationGeometry> parts_inner;
-    std::vector<RelationGeometry> parts_outer;
-    linestring_t part;
-    linestring_t lastLinestring;
-    bool justClosed = false;
-    bool first = true;
-
-    std::vector<osmobjects::OsmRelationMember> members;
-
-    // Skip members that are not Way
+    WayJoiner joiner;
     for (const auto& member : relation.members) {
-        if (member.type == osmobjects::way) {
-            members.push_back(member);
-        }
-    }
-
-    for (auto mit = members.begin(); mit != members.end(); ++mit) {
         // Process Way objects only, not Nodes or other Relations
-        if (!waycache.count(mit->ref)) {
+        if (member.type != osmobjects::way) {
+            continue;
+        }
+        auto way = waycache.find(member.ref);
+        if (!way) {
             // Way is not available in cache,
             // possibily because Relation is not in the priority area
             // or the way was deleted
             return;
         }
-
-        auto way = std::make_shared<osmobjects::OsmWay>();
-
-        way = waycache.at(mit->ref);
-
-        if (bg::num_points(way->linestring) > 0 &&
-            bg::num_points(way->polygon) == 0)
-        {
-
-            // Linestrings
-
-            if (!way->isClosed()) {
-
-                // Reverse the line direction if it's necessary
-                if (first && (std::next(mit) != members.end())) {
-                    auto nextWay = std::make_shared<osmobjects::OsmWay>();
-                    auto nextWayId = std::next(mit)->ref;
-                    if (!waycache.count(nextWayId)) {
-                        // Way is not available in cache,
-                        // possibily because Relation is not in the priority area
-                        // or the way was deleted
-                        return;
-                    }
-                    nextWay = waycache.at(nextWayId);
-
-                    if ( bg::num_points(nextWay->linestring) > 0 && 
-                        bg::num_points(way->linestring) > 0 && (
-                        bg::equals(way->linestring.front(), nextWay->linestring.front()) ||
-                        bg::equals(way->linestring.front(), nextWay->linestring.back())
-                    )) {
-                        bg::reverse(way->linestring);
-                    }
-                } else {
-                    if ( bg::num_points(way->linestring) > 0 &&
-                         bg::num_points(lastLinestring) > 0 ) {
-                        if (bg::equals(way->linestring.back(), lastLinestring.back())) {
-                            bg::reverse(way->linestring);
-                        }
-                    }
-                }
-
-                bg::append(part, way->linestring);
-
-                // Check if object is closed
-                if (relation.isMultiPolygon() && bg::equals(part.back(), part.front())) {
-                    // Convert LineString to Polygon
-                    polygon_t polygon;
-                    bg::append(polygon.outer(), part);
-                    if (mit->role == "inner") {
-                        parts_inner.push_back({
-                            linestring_t(),
-                            { polygon }
-                        });
-                    } else {
-                        parts_outer.push_back({
-                            linestring_t(),
-                            { polygon }
-                        });
-                    }
-                    part.clear();
-                    first = true;
-                    justClosed = true;
-                    lastLinestring.clear();
-                } else if (std::next(mit) != members.end()) {
-                    // Check if object is disconnected
-                    auto nextWay = std::make_shared<osmobjects::OsmWay>();
-                    auto nextWayId = std::next(mit)->ref;
-                    if (!waycache.count(nextWayId)) {
-                        // Way is not available in cache,
-                        // possibily because Relation is not in the priority area
-                        // or the way was deleted
-                        return;
-                    }
-                    nextWay = waycache.at(nextWayId);
-                    if ( (bg::num_points(way->linestring) > 0 && bg::num_points(nextWay->linestring) > 0 &&
-                        !bg::equals(way->linestring.back(), nextWay->linestring.front()) &&
-                        !bg::equals(way->linestring.back(), nextWay->linestring.back())) ||
-                        (bg::num_points(nextWay->linestring) == 0)
-                    ) {
-                        parts_outer.push_back({
-                            { part },
-                            polygon_t()
-                        });
-                        part.clear();
-                        first = true;
-                        justClosed = true;
-                        lastLinestring.clear();
-                    }
-                }
-
-
-            } else {
-                // Convert LineString to Polygon
-                if (mit->role == "inner") {
-                    parts_inner.push_back({
-                        linestring_t(),
-                        { way->polygon }
-                    });
-                } else {
-                    parts_outer.push_back({
-                        linestring_t(),
-                        { way->polygon }
-                    });
-                }
-            }
-
-            lastLinestring = way->linestring;
-
-        } else {
-
-            // Polygons
-
-            // When Relation is MultiLineString but way's geometry is a Polygon
-            if (!relation.isMultiPolygon() && bg::num_points(way->linestring) == 0 &&
-                bg::num_points(way->polygon) > 0
-            ) {
-                // Convert way's Polygon to LineString
-                bg::assign_points(way->linestring, way->polygon.outer());
-                if (mit->role == "inner") {
-                        parts_inner.push_back({
-                            { way->linestring },
-                            polygon_t()
-                        });
-                } else {
-                        parts_outer.push_back({
-                            { way->linestring },
-                            polygon_t()
-                        });
-                }
-            } else {
-                if (mit->role == "inner") {
-                    parts_inner.push_back({
-                        linestring_t(),
-                        { way->polygon }
-                    });
-                } else {
-                    if (way->polygon.outer().size() > 0) {
-                        parts_outer.push_back({
-                            linestring_t(),
-                            { way->polygon }
-                        });
-                    } else {
-                        parts_outer.push_back({
-                            { way->linestring },
-                            polygon_t()
-                        });
-                    }
-                }
-            }
-
+        // The cached Ways are only read, they may be members of other Relations
+        if (bg::num_points((*way)->linestring) > 0) {
+            joiner.add((*way)->linestring, member.role == "inner");
+        } else if (bg::num_points((*way)->polygon) > 0) {
+            joiner.add((*way)->polygon.outer(), member.role == "inner");
         }
-
-        if (first && !justClosed) {
-            first = false;
-        }
-        if (justClosed) {
-            justClosed = false;
-        }
-
     }
+    auto lines = joiner.join();
 
-    if (part.size() > 0) {
-        parts_outer.push_back({
-            { part },
-            polygon_t()
-        });
+    // MultiLineString
+    if (!relation.isMultiPolygon()) {
+        relation.multilinestring.clear();
+        for (auto& line : lines) {
+            relation.multilinestring.push_back(std::move(line.points));
+        }
+        return;
     }
 
-    // Converts all geometries to WKT strings
-
-    std::string geometry = "";
-    int i = 0;
-
-    // Inner parts
-    for (auto pit = parts_outer.begin(); pit != parts_outer.end(); ++pit) {
-        std::stringstream ss;
-        std::string geometry_str;
-        ++i;
-        if (relation.isMultiPolygon()) {
-            if (bg::num_points(pit->polygon.outer()) > 1) {
-                ss << std::setprecision(12) << bg::wkt(pit->polygon);
-                geometry_str = ss.str();
-                // Erase "POLYGON("
-                geometry_str.erase(0,8);
-                geometry_str.erase(geometry_str.size() - 1);
-                geometry += geometry_str + ",";
-            }
-        } else {
-            if (bg::num_points(pit->linestring) > 1) {
-                ss << std::setprecision(12) << bg::wkt(pit->linestring);
-                geometry_str = ss.str();
-                // Erase "LINESTRING("
-                geometry_str.erase(0,11);
-                geometry_str.erase(geometry_str.size() - 1);
-                geometry += "(" + geometry_str + "),";
-            }
+    // MultiPolygon, only closed lines are rings
+    relation.multipolygon.clear();
+    std::vector<const linestring_t *> inners;
+    std::vector<bg::model::box<point_t>> envelopes;
+    std::vector<double> areas;
+    for (const auto& line : lines) {
+        if (!isRing(line.points)) {
+            log_debug("Relation %1% has a ring that is not closed", relation.id);
+            continue;
+        }
+        if (line.inner) {
+            inners.push_back(&line.points);
+            continue;
         }
+        polygon_t polygon;
+        polygon.outer().assign(line.points.begin(), line.points.end());
+        envelopes.push_back(bg::return_envelope<bg::model::box<point_t>>(line.points));
+        areas.push_back(std::abs(bg::area(polygon)));
+        relation.multipolygon.push_back(std::move(polygon));
     }
 
-    // Outer parts
-    for (auto pit = parts_inner.begin(); pit != parts_inner.end(); ++pit) {
-        std::stringstream ss;
-        std::string geometry_str;
-        ++i;
-        if (relation.isMultiPolygon()) {
-            if (bg::num_points(pit->polygon.outer()) > 1) {
-                ss << std::setprecision(12) << bg::wkt(pit->polygon);
-                geometry_str = ss.str();
-                // Erase "POLYGON("
-                geometry_str.erase(0,8);
-                geometry_str.erase(geometry_str.size() - 1);
-                geometry += geometry_str + ",";
-            }
-        } else {
-            if (bg::num_points(pit->linestring) > 1) {
-                ss << std::setprecision(12) << bg::wkt(pit->linestring);
-                geometry_str = ss.str();
-                // Erase "LINESTRING("
-                geometry_str.erase(0,11);
-                geometry_str.erase(geometry_str.size() - 1);
-                geometry += "(" + geometry_str + "),";
+    // Every inner ring goes to the smallest outer ring containing it, so
+    // islands inside lakes end up in the right place
+    for (const auto ring : inners) {
+        auto envelope = bg::return_envelope<bg::model::box<point_t>>(*ring);
+        std::size_t outer = relation.multipolygon.size();
+        for (std::size_t i = 0; i < relation.multipolygon.size(); ++i) {
+            if ((outer == relation.multipolygon.size() || areas[i] < areas[outer]) &&
+                bg::covered_by(envelope, envelopes[i]) &&
+                (insideRing(ring->front(), relation.multipolygon[i].outer()) ||
+                 insideRing((*ring)[ring->size() / 2], relation.multipolygon[i].outer()))
+            ) {
+                outer = i;
             }
         }
-    }
-
-    // Build the final multipolygon or multilinestring to store it as the
-    // relation's geometry 
-    if (geometry.size() > 1) {
-        geometry.erase(geometry.size() - 1);
-        if (relation.isMultiPolygon()) {
-            bg::read_wkt("POLYGON(" + geometry + ")", relation.multipolygon);
-        } else {
-            bg::read_wkt("MULTILINESTRING(" + geometry + ")", relation.multilinestring);
+        if (outer == relation.multipolygon.size()) {
+            log_debug("Relation %1% has an inner ring outside of the outer rings", relation.id);
+            continue;
         }
+        relation.multipolygon[outer].inners().emplace_back(ring->begin(), ring->end());
     }
 }
 
-
 }  // namespace geobuilder
 
 // local Variables:
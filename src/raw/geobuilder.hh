@@ -33,6 +33,9 @@
 #include "data/pq.hh"
 #include "osm/osmobjects.hh"
 #include "osm/osmchange.hh"
+#include "osm/nodestore.hh"
+#include "osm/idmap.hh"
+#include "osm/nodelocations.hh"
 #include "raw/queryraw.hh"
 
 using namespace pq;
@@ -44,9 +47,43 @@ using namespace queryraw;
 /// \namespace geobuilder
 namespace geobuilder {
 
-struct RelationGeometry {
-    linestring_t linestring;
-    polygon_t polygon;
+/// A line or ring made of one or more Ways of a Relation
+struct RelationLine {
+    linestring_t points;
+    bool inner = false;         ///< Made of Ways with the "inner" role
+};
+
+/// \class WayJoiner
+/// \brief Joins the Ways of a Relation into lines and rings
+///
+/// The ends of every Way are kept in a hash index, so the Way continuing
+/// a line is found with a lookup instead of expecting the members to be
+/// sorted. Ways are only joined to Ways with the same role. The points
+/// are copied to the lines, the Ways are never modified.
+class WayJoiner {
+  public:
+    /// Add the geometry of a Way, in the order of the members. It must
+    /// stay alive until join() is called.
+    void add(const std::vector<point_t> &points, bool inner);
+    /// Join the Ways, the lines are in the order of their first member
+    std::vector<RelationLine> join(void);
+
+  private:
+    static constexpr uint32_t none = UINT32_MAX;
+    /// Add the end of a Way to the index. Ends are numbered 2 * way for
+    /// the front and 2 * way + 1 for the back.
+    void index(uint32_t endpoint, long key);
+    /// Return the end of an unused Way at a location, from the first
+    /// member if there is more than one, or none
+    uint32_t next(const point_t &point, bool inner) const;
+    /// Append Ways to a line until it reaches stop or can't continue
+    void extend(linestring_t &line, bool inner, long stop);
+
+    std::vector<const std::vector<point_t> *> ways;
+    std::vector<bool> roles;            ///< The Way is an inner
+    std::vector<bool> used;             ///< The Way is already in a line
+    osmobjects::IdMap<uint32_t> heads;  ///< The first end at each location
+    std::vector<uint32_t> chain;        ///< The next end at the same location
 };
 
 /// \class GeoBuilder
@@ -56,12 +93,15 @@ struct RelationGeometry {
 /// from Nodes, Ways and Relationships to Points, LineStrings and Polygons
 class GeoBuilder {
   public:
-    GeoBuilder(multipolygon_t &_poly, const std::shared_ptr<QueryRaw> &queryraw);
+    GeoBuilder(multipolygon_t &_poly, const std::shared_ptr<QueryRaw> &queryraw,
+               const std::shared_ptr<NodeLocations> &nodelocations = nullptr,
+               unsigned int concurrency = 1);
     ~GeoBuilder();
     /// Build all geometries for a OsmChange file
     void buildGeometries(std::shared_ptr<OsmChangeFile> &osmchanges);
   // private:
     void preProcessChanges(std::shared_ptr<OsmChangeFile> &osmchanges);
+    void fetchContext(std::shared_ptr<OsmChangeFile> &osmchanges);
     void addIndirectlyModifiedWays(std::shared_ptr<OsmChangeFile> &osmchanges);
     void addIndirectlyModifiedRelations(std::shared_ptr<OsmChangeFile> &osmchanges);
     void fillNodeCache(std::shared_ptr<OsmChangeFile> &osmchanges);
@@ -69,16 +109,22 @@ class GeoBuilder {
     void buildWays(std::shared_ptr<OsmChangeFile> &osmchanges);
     void buildRelations(std::shared_ptr<OsmChangeFile> &osmchanges);
     void buildRelationGeometry(osmobjects::OsmRelation &relation);
-    std::map<long, std::shared_ptr<osmobjects::OsmNode>> nodecache;
-    std::map<long, std::shared_ptr<osmobjects::OsmWay>> waycache;
-    std::vector<long> referencedNodeIds;
+    osmobjects::NodeStore nodecache;
+    osmobjects::IdMap<std::shared_ptr<osmobjects::OsmWay>> waycache;
+    osmobjects::IdSet referencedNodeIds;
     std::vector<long> modifiedNodesIds;
-    std::vector<long> modifiedWaysIds;
-    std::vector<long> modifiedRelsIds;
-    std::vector<long> removedWays;
-    std::vector<long> removedRelations;
+    osmobjects::IdSet modifiedWaysIds;
+    osmobjects::IdSet modifiedRelsIds;
+    osmobjects::IdSet removedWays;
+    osmobjects::IdSet removedRelations;
+    /// What was read from the DB for this change
+    QueryRaw::Context context;
     const multipolygon_t &poly;
     const std::shared_ptr<QueryRaw> &queryraw;
+    /// Local index of node locations, checked before querying the DB
+    std::shared_ptr<NodeLocations> nodelocations;
+    /// Number of threads used to build the geometries of Ways and Relations
+    unsigned int concurrency;
 
 };
 
@@ -30,6 +30,7 @@
 #include "unconfig.h"
 #endif
 
+#include <algorithm>
 #include <map>
 #include <string>
 #include <iostream>
@@ -43,8 +44,10 @@
 #include "utils/log.hh"
 #include "data/pq.hh"
 #include "raw/queryraw.hh"
+#include "raw/wkb.hh"
 #include "osm/osmobjects.hh"
 #include "osm/osmchange.hh"
+#include "osm/idmap.hh"
 
 using namespace pq;
 using namespace logger;
@@ -57,10 +60,125 @@ namespace queryraw {
 
 const std::string QueryRaw::polyTable = "ways_poly";
 const std::string QueryRaw::lineTable = "ways_line";
+const std::string QueryRaw::wayRefsTable = "way_refs";
+const std::string QueryRaw::relationMembersTable = "relation_members";
+
+const std::size_t QueryRaw::maxIdsPerQuery = 50000;
+
+// The context of a change, the indirectly modified Ways and Relations, found
+// with the reverse indexes, and the geometries and locations they need, in a
+// single statement, so the geometries are built after one round trip. The ids are
+// $1 modifiedNodes, $2 skipWays, $3 modifiedWays, $4 skipRelations,
+// $5 memberWays and $6 nodes. The kind column says what every row is, p and
+// l for the indirectly modified Ways, r for the Relations, P and L for the
+// geometries of the Ways and n for the Nodes.
+static std::string
+contextQuery(bool refNodes)
+{
+    const std::string ways = "osm_id, refs, version, tags, uid, changeset FROM ";
+    return "WITH referencing AS (SELECT way_id FROM " + QueryRaw::wayRefsTable + " WHERE node_id = ANY($1)), "
+        "polys AS (SELECT " + ways + QueryRaw::polyTable + " WHERE osm_id IN (SELECT way_id FROM referencing) AND osm_id NOT IN (SELECT unnest($2::int8[]))), "
+        "lines AS (SELECT " + ways + QueryRaw::lineTable + " WHERE osm_id IN (SELECT way_id FROM referencing) AND osm_id NOT IN (SELECT unnest($2::int8[]))), "
+        "modified AS (SELECT unnest($3::int8[]) AS osm_id UNION SELECT osm_id FROM polys UNION SELECT osm_id FROM lines), "
+        "rels AS (SELECT osm_id, refs, version, tags, uid, changeset FROM relations WHERE osm_id IN "
+            "(SELECT relation_id FROM " + QueryRaw::relationMembersTable + " WHERE member_type = 'w' "
+            "AND member_ref IN (SELECT osm_id FROM modified)) AND osm_id NOT IN (SELECT unnest($4::int8[]))), "
+        "members AS (SELECT osm_id FROM modified UNION SELECT unnest($5::int8[]) "
+            "UNION SELECT member_ref FROM " + QueryRaw::relationMembersTable + " WHERE member_type = 'w' "
+            "AND relation_id IN (SELECT osm_id FROM rels)), "
+        "located AS (SELECT unnest($6::int8[]) AS osm_id" +
+            (refNodes ? " UNION SELECT unnest(refs) FROM polys UNION SELECT unnest(refs) FROM lines" : "") + ") "
+        "SELECT osm_id, refs::text, version, tags, uid, changeset, NULL::geometry AS geom, 'p' AS kind FROM polys "
+        "UNION ALL SELECT osm_id, refs::text, version, tags, uid, changeset, NULL, 'l' FROM lines "
+        "UNION ALL SELECT osm_id, refs::text, version, tags, uid, changeset, NULL, 'r' FROM rels "
+        "UNION ALL SELECT osm_id, refs::text, NULL, NULL, NULL, NULL, geom, 'P' FROM " + QueryRaw::polyTable +
+            " WHERE osm_id IN (SELECT osm_id FROM members) "
+        "UNION ALL SELECT osm_id, refs::text, NULL, NULL, NULL, NULL, geom, 'L' FROM " + QueryRaw::lineTable +
+            " WHERE osm_id IN (SELECT osm_id FROM members) "
+        "UNION ALL SELECT osm_id, NULL, NULL, NULL, NULL, NULL, geom, 'n' FROM nodes WHERE osm_id IN (SELECT osm_id FROM located);";
+}
 
 QueryRaw::QueryRaw(std::shared_ptr<Pq> db) {
     dbconn = db;
     utils = std::make_shared<DataUtils>(db);
+
+    // Lookups by id take the ids as an int8[] parameter, so the statements are
+    // parsed and planned once, whatever the number of ids
+    dbconn->prepare("nodes_by_ids", "SELECT osm_id, st_x(geom) AS lat, st_y(geom) AS lon FROM nodes WHERE osm_id = ANY($1);");
+    // Geometries come back as hex EWKB, the text output of a geometry column,
+    // and osm_id is the primary key of both tables, so nothing is deduplicated.
+    // The columns of Ways and Relations are always osm_id, refs, version, tags,
+    // uid, changeset, geom and kind, so the same code reads all the statements.
+    dbconn->prepare("ways_by_ids", "SELECT osm_id, refs, NULL, NULL, NULL, NULL, geom, 'P' AS kind FROM " + QueryRaw::polyTable + " WHERE osm_id = ANY($1) "
+        "UNION ALL SELECT osm_id, refs, NULL, NULL, NULL, NULL, geom, 'L' FROM " + QueryRaw::lineTable + " WHERE osm_id = ANY($1);");
+    dbconn->prepare("context", contextQuery(true));
+    dbconn->prepare("context_without_refs", contextQuery(false));
+}
+
+// The reverse indexes are needed by every write of a Way or a Relation, so
+// the replicator doesn't run without them
+bool
+QueryRaw::migrate(void)
+{
+    return migrateTable(wayRefsTable,
+        "CREATE TABLE IF NOT EXISTS public." + wayRefsTable + " (way_id int8 NOT NULL, node_id int8 NOT NULL, "
+            "CONSTRAINT " + wayRefsTable + "_pkey PRIMARY KEY (way_id, node_id));", {
+        "INSERT INTO " + wayRefsTable + " SELECT DISTINCT osm_id, unnest(refs) FROM " + polyTable + " ON CONFLICT DO NOTHING;",
+        "INSERT INTO " + wayRefsTable + " SELECT DISTINCT osm_id, unnest(refs) FROM " + lineTable + " ON CONFLICT DO NOTHING;",
+        "CREATE INDEX IF NOT EXISTS " + wayRefsTable + "_node_id_idx ON public." + wayRefsTable + " (node_id);"
+    }) && migrateTable(relationMembersTable,
+        "CREATE TABLE IF NOT EXISTS public." + relationMembersTable + " (relation_id int8 NOT NULL, "
+            "member_type char(1) NOT NULL, member_ref int8 NOT NULL, "
+            "CONSTRAINT " + relationMembersTable + "_pkey PRIMARY KEY (relation_id, member_type, member_ref));", {
+        "INSERT INTO " + relationMembersTable + " SELECT DISTINCT osm_id, left(m->>'type', 1), (m->>'ref')::int8 "
+            "FROM relations, jsonb_array_elements(refs) AS m WHERE m->>'type' <> '' ON CONFLICT DO NOTHING;",
+        "CREATE INDEX IF NOT EXISTS " + relationMembersTable + "_member_idx ON public." + relationMembersTable + " (member_type, member_ref);"
+    });
+}
+
+bool
+QueryRaw::migrateTable(const std::string &table, const std::string &create,
+                       const std::vector<std::string> &fill)
+{
+    bool committed = false;
+    dbconn->execute("migration of " + table, [&](Pq::Lease &conn) {
+        pqxx::work worker(*conn);
+        worker.exec(create);
+        if (!worker.exec("SELECT EXISTS (SELECT 1 FROM " + table + ");")[0][0].as<bool>()) {
+            log_info("Filling %1% from the raw tables, this can take a while", table);
+            for (const auto &statement : fill) {
+                worker.exec(statement);
+            }
+        }
+        worker.commit();
+        committed = true;
+        return pqxx::result();
+    });
+    return committed;
+}
+
+std::vector<pqxx::result>
+QueryRaw::queryIds(const std::string &statement, const std::vector<long> &ids) const
+{
+    std::vector<pqxx::result> results;
+    for (std::size_t begin = 0; begin < ids.size(); begin += maxIdsPerQuery) {
+        auto end = ids.begin() + std::min(begin + maxIdsPerQuery, ids.size());
+        results.push_back(dbconn->queryIds(statement, std::vector<long>(ids.begin() + begin, end)));
+    }
+    return results;
+}
+
+// Make sure we have what's needed to insert or update a Way:
+// - At least 2 points
+// - A LineString or a Polygon, with a point for every ref
+bool
+QueryRaw::validGeometry(const OsmWay &way)
+{
+    if (bg::num_points(way.linestring) < 2 && bg::num_points(way.polygon) < 2) {
+        return false;
+    }
+    return (way.refs.front() != way.refs.back() && way.refs.size() == bg::num_points(way.linestring)) ||
+        (way.refs.front() == way.refs.back() && way.refs.size() == bg::num_points(way.polygon));
 }
 
 // Apply change functions receive an OSM feature
@@ -75,10 +193,9 @@ QueryRaw::applyChange(const OsmNode &node) const
     // If create or modify, then insert or update
     if ((node.action == osmobjects::create || node.action == osmobjects::modify)) {
         std::string query = "INSERT INTO nodes AS r (osm_id, geom, tags, timestamp, version, \"user\", uid, changeset) VALUES(";
-        std::string format = "%d, ST_GeomFromText(\'%s\', 4326), %s, \'%s\', %d, \'%s\', %d, %d)";
+        std::string format = "%d, %s, %s, \'%s\', %d, \'%s\', %d, %d)";
 
-        format.append(" ON CONFLICT (osm_id) DO UPDATE SET geom = ST_GeomFromText(\'%s\', \
-        4326), tags = %s, timestamp = \'%s\', version = %d, \"user\" = \'%s\', uid = %d, changeset = %d WHERE r.version < %d;");
+        format.append(" ON CONFLICT (osm_id) DO UPDATE SET geom = EXCLUDED.geom, tags = %s, timestamp = \'%s\', version = %d, \"user\" = \'%s\', uid = %d, changeset = %d WHERE r.version < %d;");
 
         boost::format fmt(format);
 
@@ -88,10 +205,8 @@ QueryRaw::applyChange(const OsmNode &node) const
         fmt % node.id;
 
         // geometry
-        std::stringstream ss;
-        ss << std::setprecision(12) << bg::wkt(node.point);
-        std::string geometry = ss.str();
-        fmt % geometry;
+        wkb::EWKBWriter writer;
+        fmt % writer.literal(node.point);
 
         // tags
         auto tags = utils->buildTagsQuery(node.tags);
@@ -115,7 +230,6 @@ QueryRaw::applyChange(const OsmNode &node) const
         fmt % node.changeset;
 
         // ON CONFLICT (update)
-        fmt % geometry;
         fmt % tags;
         fmt % timestamp;
         fmt % node.version;
@@ -142,31 +256,25 @@ QueryRaw::applyChange(const OsmWay &way) const
 {
     auto queries = std::make_shared<std::vector<std::string>>();
 
-    // Make sure we have what's needed to insert or update a Way:
-    // - At least 2 points
-    // - A LineString or a Polygon
-    // - A create, modify or "modify geometry" action.
-    if ((bg::num_points(way.linestring) >= 2 || bg::num_points(way.polygon) >= 2)
-        && (way.action == osmobjects::create || way.action == osmobjects::modify
-        || way.action == osmobjects::modify_geom)) {
+    // Insert or update a Way with a create, modify or "modify geometry" action
+    if (way.action == osmobjects::create || way.action == osmobjects::modify
+        || way.action == osmobjects::modify_geom) {
 
-        if ((way.refs.front() != way.refs.back() && way.refs.size() == bg::num_points(way.linestring)) ||
-            (way.refs.front() == way.refs.back() && way.refs.size() == bg::num_points(way.polygon))
-         ) {
+        if (validGeometry(way)) {
 
             std::string query;
             const std::string* tableName;
-            std::stringstream ss;
+            wkb::EWKBWriter writer;
+            std::string geometry;
 
-            // Get a Polygon or LineString geometry string depending on the Way's geometry
+            // Get a Polygon or LineString geometry depending on the Way's geometry
             if (way.isClosed()) {
                 tableName = &QueryRaw::polyTable;
-                ss << std::setprecision(12) << bg::wkt(way.polygon);
+                geometry = writer.literal(way.polygon);
             } else {
                 tableName = &QueryRaw::lineTable;
-                ss << std::setprecision(12) << bg::wkt(way.linestring);
+                geometry = writer.literal(way.linestring);
             }
-            std::string geostring = ss.str();
 
             // Insert or update the full Way, including id, tags, refs, geometry, timestamp, version,
             // user, uid and changeset
@@ -177,7 +285,7 @@ QueryRaw::applyChange(const OsmWay &way) const
                 query = "INSERT INTO " + *tableName + " AS r (osm_id, tags, refs, geom, timestamp, version, \"user\", uid, changeset) VALUES(";
                 std::string format = "%d, %s, %s, %s, \'%s\', %d, \'%s\', %d, %d)";
 
-                format.append(" ON CONFLICT (osm_id) DO UPDATE SET tags = %s, refs = %s, geom = %s, timestamp = \'%s\', version = %d, \"user\" = \'%s\', uid = %d, changeset = %d WHERE r.version <= %d;");
+                format.append(" ON CONFLICT (osm_id) DO UPDATE SET tags = %s, refs = %s, geom = EXCLUDED.geom, timestamp = \'%s\', version = %d, \"user\" = \'%s\', uid = %d, changeset = %d WHERE r.version <= %d;");
 
                 boost::format fmt(format);
 
@@ -198,8 +306,6 @@ QueryRaw::applyChange(const OsmWay &way) const
                 fmt % refs;
 
                 // geometry
-                std::string geometry;
-                geometry = "ST_GeomFromText(\'" + geostring + "\', 4326)";
                 fmt % geometry;
 
                 // timestamp
@@ -223,7 +329,6 @@ QueryRaw::applyChange(const OsmWay &way) const
                 // ON CONFLICT (update)
                 fmt % tags;
                 fmt % refs;
-                fmt % geometry;
                 fmt % timestamp;
                 fmt % way.version;
                 fmt % dbconn->escapedString(way.user);
@@ -234,6 +339,14 @@ QueryRaw::applyChange(const OsmWay &way) const
                 query += fmt.str();
                 queries->push_back(query);
 
+                // Update the reverse index of referenced Nodes, using the refs that
+                // were actually stored, as older versions don't replace newer ones
+                if (way.action != osmobjects::create) {
+                    queries->push_back("DELETE FROM " + QueryRaw::wayRefsTable + " WHERE way_id = " + std::to_string(way.id) + ";");
+                }
+                queries->push_back("INSERT INTO " + QueryRaw::wayRefsTable + " (way_id, node_id) SELECT DISTINCT osm_id, unnest(refs) FROM "
+                    + *tableName + " WHERE osm_id = " + std::to_string(way.id) + " ON CONFLICT DO NOTHING;");
+
             } else {
 
                 // Update only the Way's geometry. This is the case when a Way was indirectly 
@@ -247,8 +360,6 @@ QueryRaw::applyChange(const OsmWay &way) const
                 boost::format fmt(format);
 
                 // Geometry
-                std::string geometry;
-                geometry = "ST_GeomFromText(\'" + geostring + "\', 4326)";
                 fmt % geometry;
 
                 // Timestamp
@@ -270,18 +381,21 @@ QueryRaw::applyChange(const OsmWay &way) const
             // If the Way's geometry is a LineString, remove all Polygons from the Polygons table.
             // If the Way's geometry is a Polygon, remove all LineString from the LineStrings table.
             // This is for preventing duplicated Way geometries. For example, when the Way was a
-            // LineString but it was then closed and converted to a Polygon.
-            std::string delquery = "DELETE FROM %s WHERE osm_id=%d;";
-            boost::format delquery_fmt(delquery);
-            if (tableName == &QueryRaw::polyTable) {
-                log_debug("Delete Way %1% from table %2%", way.id, QueryRaw::lineTable);
-                delquery_fmt % QueryRaw::lineTable;
-            } else {
-                log_debug("Delete Way %1% from table %2%", way.id, QueryRaw::polyTable);
-                delquery_fmt % QueryRaw::polyTable;
+            // LineString but it was then closed and converted to a Polygon. It's skipped when
+            // the Way is known to be stored in the same table.
+            if (way.mayChangeTable()) {
+                std::string delquery = "DELETE FROM %s WHERE osm_id=%d;";
+                boost::format delquery_fmt(delquery);
+                if (tableName == &QueryRaw::polyTable) {
+                    log_debug("Delete Way %1% from table %2%", way.id, QueryRaw::lineTable);
+                    delquery_fmt % QueryRaw::lineTable;
+                } else {
+                    log_debug("Delete Way %1% from table %2%", way.id, QueryRaw::polyTable);
+                    delquery_fmt % QueryRaw::polyTable;
+                }
+                delquery_fmt % way.id;
+                queries->push_back(delquery_fmt.str());
             }
-            delquery_fmt % way.id;
-            queries->push_back(delquery_fmt.str());
         }
     } else if (way.action == osmobjects::remove) {
 
@@ -289,6 +403,7 @@ QueryRaw::applyChange(const OsmWay &way) const
         log_debug("Delete Way %1%", way.id);
         queries->push_back("DELETE FROM " + QueryRaw::polyTable + " WHERE osm_id = " + std::to_string(way.id) + ";");
         queries->push_back("DELETE FROM " + QueryRaw::lineTable + " WHERE osm_id = " + std::to_string(way.id) + ";");
+        queries->push_back("DELETE FROM " + QueryRaw::wayRefsTable + " WHERE way_id = " + std::to_string(way.id) + ";");
     }
 
     return queries;
@@ -304,18 +419,25 @@ QueryRaw::applyChange(const OsmRelation &relation) const
     // Create, modify or modify the geometry of a Relation
     if (relation.action == osmobjects::create || relation.action == osmobjects::modify || relation.action == osmobjects::modify_geom) {
 
-        // Get a Polygon or LineString geometry string depending on the Relation
-        std::stringstream ss;
+        // Get a Polygon or LineString geometry depending on the Relation
+        wkb::EWKBWriter writer;
+        std::string geometry;
+        std::size_t points;
         if (relation.isMultiPolygon()) {
-            ss << std::setprecision(12) << bg::wkt(relation.multipolygon);
+            points = bg::num_points(relation.multipolygon);
+            // A single outer ring is stored as a Polygon
+            if (relation.multipolygon.size() == 1) {
+                geometry = writer.literal(relation.multipolygon.front());
+            } else {
+                geometry = writer.literal(relation.multipolygon);
+            }
         } else {
-            ss << std::setprecision(12) << bg::wkt(relation.multilinestring);
+            points = bg::num_points(relation.multilinestring);
+            geometry = writer.literal(relation.multilinestring);
         }
-        std::string geostring = ss.str();
 
         // Ignore empty geometries
-        if (geostring != "MULTILINESTRING()" && geostring != "POLYGON()"
-            && geostring != "MULTILINESTRING(())" && geostring != "POLYGON(())") {
+        if (points > 0) {
 
             // Insert or update the full Relation, including id, tags, refs, geometry, timestamp,
             // version, user, uid and changeset
@@ -324,7 +446,7 @@ QueryRaw::applyChange(const OsmRelation &relation) const
                 query = "INSERT INTO relations as r (osm_id, tags, refs, geom, timestamp, version, \"user\", uid, changeset) VALUES(";
                 std::string format = "%d, %s, %s, %s, \'%s\', %d, \'%s\', %d, %d)";
 
-                format.append(" ON CONFLICT (osm_id) DO UPDATE SET tags = %s, refs = %s, geom = %s, timestamp = \'%s\', version = %d, \"user\" = \'%s\', uid = %d, changeset = %d WHERE r.version <= %d;");
+                format.append(" ON CONFLICT (osm_id) DO UPDATE SET tags = %s, refs = %s, geom = EXCLUDED.geom, timestamp = \'%s\', version = %d, \"user\" = \'%s\', uid = %d, changeset = %d WHERE r.version <= %d;");
             
                 boost::format fmt(format);
 
@@ -342,8 +464,6 @@ QueryRaw::applyChange(const OsmRelation &relation) const
                 fmt % refs;
 
                 // geometry
-                std::string geometry;
-                geometry = "ST_GeomFromText(\'" + geostring + "\', 4326)";
                 fmt % geometry;
 
                 // timestamp
@@ -366,7 +486,6 @@ QueryRaw::applyChange(const OsmRelation &relation) const
                 // ON CONFLICT
                 fmt % tags;
                 fmt % refs;
-                fmt % geometry;
                 fmt % timestamp;
                 fmt % relation.version;
                 fmt % dbconn->escapedString(relation.user);
@@ -377,6 +496,15 @@ QueryRaw::applyChange(const OsmRelation &relation) const
                 query.append(fmt.str());
                 queries->push_back(query);
 
+                // Update the reverse index of members, using the members that were
+                // actually stored, as older versions don't replace newer ones
+                if (relation.action != osmobjects::create) {
+                    queries->push_back("DELETE FROM " + QueryRaw::relationMembersTable + " WHERE relation_id = " + std::to_string(relation.id) + ";");
+                }
+                queries->push_back("INSERT INTO " + QueryRaw::relationMembersTable + " (relation_id, member_type, member_ref) "
+                    "SELECT DISTINCT osm_id, left(m->>'type', 1), (m->>'ref')::int8 FROM relations, jsonb_array_elements(refs) AS m "
+                    "WHERE osm_id = " + std::to_string(relation.id) + " AND m->>'type' <> '' ON CONFLICT DO NOTHING;");
+
             } else {
 
                 // Update only the Relation's geometry. This is the case when a Relation was indirectly 
@@ -390,8 +518,6 @@ QueryRaw::applyChange(const OsmRelation &relation) const
                 boost::format fmt(format);
 
                 // Geometry
-                std::string geometry;
-                geometry = "ST_GeomFromText(\'" + geostring + "\', 4326)";
                 fmt % geometry;
 
                 // Timestamp
@@ -414,6 +540,7 @@ QueryRaw::applyChange(const OsmRelation &relation) const
         log_debug("Delete Relation %1%", relation.id);
         // Delete a Relation geometry and its references.
         queries->push_back("DELETE FROM relations WHERE osm_id = " + std::to_string(relation.id) + ";");
+        queries->push_back("DELETE FROM " + QueryRaw::relationMembersTable + " WHERE relation_id = " + std::to_string(relation.id) + ";");
     }
 
     return queries;
@@ -421,62 +548,122 @@ QueryRaw::applyChange(const OsmRelation &relation) const
 
 // Get functions are for getting OSM features
 
-// Get Relations by referenced Ways ids
-std::vector<std::shared_ptr<osmobjects::OsmRelation>>
-QueryRaw::getRelationsByWaysRefs(const std::string &wayIds) const
+std::shared_ptr<OsmWay>
+QueryRaw::readWay(const pqxx::row &row) const
+{
+    auto way = std::make_shared<OsmWay>();
+    way->id = row[0].as<long>();
+    way->refs = utils->arrayStrToVector(row[1].view());
+    way->version = row[2].as<long>();
+    if (!row[3].is_null() && !utils->parseTagsJSON(row[3].view(), way->tags)) {
+        log_error("Couldn't parse the tags of way %1%", way->id);
+    }
+    if (!row[4].is_null()) {
+        way->uid = row[4].as<long>();
+    }
+    if (!row[5].is_null()) {
+        way->changeset = row[5].as<long>();
+    }
+    return way;
+}
+
+std::shared_ptr<OsmRelation>
+QueryRaw::readRelation(const pqxx::row &row) const
+{
+    auto rel = std::make_shared<OsmRelation>();
+    rel->id = row[0].as<long>();
+    if (!utils->parseMembersJSON(row[1].view(), rel->members)) {
+        log_error("Couldn't parse the members of relation %1%", rel->id);
+    }
+    rel->version = row[2].as<long>();
+    if (!row[3].is_null() && !utils->parseTagsJSON(row[3].view(), rel->tags)) {
+        log_error("Couldn't parse the tags of relation %1%", rel->id);
+    }
+    if (!row[4].is_null()) {
+        rel->uid = row[4].as<long>();
+    }
+    if (!row[5].is_null()) {
+        rel->changeset = row[5].as<long>();
+    }
+    return rel;
+}
+
+std::shared_ptr<OsmWay>
+QueryRaw::readGeometry(const pqxx::row &row) const
+{
+    auto way = std::make_shared<OsmWay>();
+    way->id = row[0].as<long>();
+    auto geom = row[6];
+    if (geom.is_null()) {
+        return nullptr;
+    }
+    wkb::EWKBReader reader;
+    bool valid;
+    if (row[7].view() == "P") {
+        way->stored = waytable_t::poly;
+        valid = reader.read(geom.view(), way->polygon);
+    } else {
+        way->stored = waytable_t::line;
+        valid = reader.read(geom.view(), way->linestring);
+    }
+    if (!valid) {
+        log_error("Invalid geometry for Way %1%", way->id);
+        return nullptr;
+    }
+    if (!row[1].is_null()) {
+        way->refs = utils->arrayStrToVector(row[1].view());
+    }
+    return way;
+}
+
+QueryRaw::Context
+QueryRaw::getContext(const ContextIds &ids) const
 {
 #ifdef TIMING_DEBUG
-    boost::timer::auto_cpu_timer timer("getRelationsByWaysRefs(wayIds): took %w seconds\n");
+    boost::timer::auto_cpu_timer timer("getContext(ids): took %w seconds\n");
 #endif
-    // Object to return
-    std::vector<std::shared_ptr<OsmRelation>> rels;
-
-    // Query for getting Relations
-    std::string relsQuery = "SELECT distinct(osm_id), refs, version, tags, uid, changeset FROM relations WHERE EXISTS (SELECT 1 FROM jsonb_array_elements(refs) AS ref WHERE (ref->>'ref')::bigint IN (" + wayIds + "));";
-    auto rels_result = dbconn->query(relsQuery);
-
-    // Fill vector with OsmRelation objects
-    for (auto rel_it = rels_result.begin(); rel_it != rels_result.end(); ++rel_it) {
-        auto rel = std::make_shared<osmobjects::OsmRelation>();
-        rel->id = (*rel_it)[0].as<long>();
-        std::string refs_str = (*rel_it)[1].as<std::string>();
-        auto members = utils->parseJSONArrayStr(refs_str);
-
-        for (auto mit = members.begin(); mit != members.end(); ++mit) {
-            auto memberType = osmobjects::osmtype_t::way;
-            if (mit->at("type") == "n") {
-                memberType = osmobjects::osmtype_t::node;
-            } else if (mit->at("type") == "r") {
-                memberType = osmobjects::osmtype_t::relation;
+    Context context;
+    if (ids.empty()) {
+        return context;
+    }
+    auto result = dbconn->queryIds(ids.refNodes ? "context" : "context_without_refs",
+        {ids.modifiedNodes, ids.skipWays, ids.modifiedWays, ids.skipRelations, ids.memberWays, ids.nodes});
+    wkb::EWKBReader reader;
+    for (const auto &row : result) {
+        switch (row[7].view().front()) {
+            case 'p':
+            case 'l': {
+                auto way = readWay(row);
+                way->stored = row[7].view() == "p" ? waytable_t::poly : waytable_t::line;
+                context.ways.push_back(way);
+                break;
             }
-            rel->addMember(std::stol(mit->at("ref")), memberType, mit->at("role"));
-        }
-
-        rel->version = (*rel_it)[2].as<long>();
-        auto tags = (*rel_it)[3];
-        if (!tags.is_null()) {
-            auto tags = utils->parseJSONObjectStr((*rel_it)[3].as<std::string>());
-            for (auto const& [key, val] : tags)
-            {
-                rel->addTag(key, val);
+            case 'r':
+                context.relations.push_back(readRelation(row));
+                break;
+            case 'n': {
+                point_t point;
+                if (reader.read(row[6].view(), point)) {
+                    auto node = std::make_shared<OsmNode>(point.y(), point.x());
+                    node->id = row[0].as<long>();
+                    context.nodes.push_back(node);
+                }
+                break;
             }
+            default:
+                if (auto way = readGeometry(row)) {
+                    context.geometries.push_back(way);
+                }
         }
-        auto uid = (*rel_it)[4];
-        if (!uid.is_null()) {
-            rel->uid = (*rel_it)[4].as<long>();
-        }
-        auto changeset = (*rel_it)[5];
-        if (!changeset.is_null()) {
-            rel->changeset = (*rel_it)[5].as<long>();
-        }
-        rels.push_back(rel);
     }
-    return rels;
+    log_debug("Context: %1% ways, %2% relations, %3% geometries and %4% nodes", context.ways.size(),
+              context.relations.size(), context.geometries.size(), context.nodes.size());
+    return context;
 }
 
 // Get Ways by ids
 std::vector<std::shared_ptr<osmobjects::OsmWay>>
-QueryRaw::getWaysByIds(const std::string &waysIds) const {
+QueryRaw::getWaysByIds(const std::vector<long> &waysIds) const {
 #ifdef TIMING_DEBUG
     boost::timer::auto_cpu_timer timer("getWaysByIds(waysIds): took %w seconds\n");
 #endif
@@ -484,51 +671,32 @@ QueryRaw::getWaysByIds(const std::string &waysIds) const {
     std::vector<std::shared_ptr<osmobjects::OsmWay>> ways;
 
     // Get Ways and it's geometries (Polygon and LineString)
-    std::string waysQuery = "SELECT distinct(osm_id), ST_AsText(geom, 4326), 'polygon' AS type, refs FROM ways_poly wp WHERE osm_id = any(ARRAY[" + waysIds + "]) ";
-    waysQuery += "UNION SELECT distinct(osm_id), ST_AsText(geom, 4326), 'linestring' AS type, refs FROM ways_line wp WHERE osm_id = any(ARRAY[" + waysIds + "]);";
-    auto ways_result = dbconn->query(waysQuery);
-    if (ways_result.size() == 0) {
-        log_debug("No results returned!");
-        return ways;
-    }
-
-    std::string resultIds = "";
-
-    for (auto way_it = ways_result.begin(); way_it != ways_result.end(); ++way_it) {
-        auto way = std::make_shared<OsmWay>();
-        auto type = (*way_it)[2].as<std::string>();
-        way->id = (*way_it)[0].as<long>();
-        auto geom = (*way_it)[1];
-        if (!geom.is_null()) {
-            if (type == "polygon") {
-                bg::read_wkt((*way_it)[1].as<std::string>(), way->polygon);
-            } else {
-                bg::read_wkt((*way_it)[1].as<std::string>(), way->linestring);
-            }
-            auto refs = (*way_it)[3];
-            if (!refs.is_null()) {
-                std::string refs_str = refs.as<std::string>();
-                way->refs = utils->arrayStrToVector(refs_str);
+    for (const auto& ways_result : queryIds("ways_by_ids", waysIds)) {
+        for (const auto &row : ways_result) {
+            if (auto way = readGeometry(row)) {
+                ways.push_back(way);
             }
-            ways.push_back(way);
         }
     }
+    if (ways.empty()) {
+        log_debug("No results returned!");
+    }
     return ways;
 }
 
 // Get Nodes by ids
 std::vector<std::shared_ptr<osmobjects::OsmNode>>
-QueryRaw::getNodesByIds(const std::string &nodeIds) const {
+QueryRaw::getNodesByIds(const std::vector<long> &nodeIds) const {
     std::vector<std::shared_ptr<osmobjects::OsmNode>> nodes;
-    std::string nodesQuery = "SELECT osm_id, st_x(geom) AS lat, st_y(geom) AS lon FROM nodes WHERE osm_id IN (" + nodeIds + ");";
-    auto result = dbconn->query(nodesQuery);
-    for (const auto& n : result) {
-        auto node_id = n[0].as<long>();
-        auto node_lat = n[2].as<double>();
-        auto node_lon = n[1].as<double>();
-        OsmNode node(node_lat, node_lon);
-        node.id = node_id;
-        nodes.push_back(std::make_shared<osmobjects::OsmNode>(node));
+    for (const auto& result : queryIds("nodes_by_ids", nodeIds)) {
+        for (const auto& n : result) {
+            auto node_id = n[0].as<long>();
+            auto node_lat = n[2].as<double>();
+            auto node_lon = n[1].as<double>();
+            OsmNode node(node_lat, node_lon);
+            node.id = node_id;
+            nodes.push_back(std::make_shared<osmobjects::OsmNode>(node));
+        }
     }
     return nodes;
 }
@@ -541,74 +709,16 @@ QueryRaw::getNodesFromWays(const std::shared_ptr<std::vector<OsmWay>> &ways) con
     boost::timer::auto_cpu_timer timer("getNodeCacheFromWays(ways): took %w seconds\n");
 #endif
 
-    // Build a string list of all Nodes ids referenced from Ways
-    std::string nodeIds;
+    // Build a list of all Nodes ids referenced from Ways
+    std::vector<long> nodeIds;
     for (auto wit = ways->begin(); wit != ways->end(); ++wit) {
-        for (auto rit = std::begin(wit->refs); rit != std::end(wit->refs); ++rit) {
-            nodeIds += std::to_string(*rit) + ",";
-        }
-    }
-    if (nodeIds.size() > 1) {
-        nodeIds.erase(nodeIds.size() - 1);
+        nodeIds.insert(nodeIds.end(), std::begin(wit->refs), std::end(wit->refs));
     }
 
     auto nodes = getNodesByIds(nodeIds);
     return nodes;
 }
 
-// Get Ways that have Nodes in their references
-std::vector<std::shared_ptr<osmobjects::OsmWay>>
-QueryRaw::getWaysByNodesRefs(const std::string &nodeIds) const
-{
-#ifdef TIMING_DEBUG
-    boost::timer::auto_cpu_timer timer("getWaysByNodesRefs(nodeIds): took %w seconds\n");
-#endif
-    std::vector<std::shared_ptr<osmobjects::OsmWay>> ways;
-    std::vector<std::string> queries;
-
-    // Get all Ways that have references to Nodes from the DB, including Polygons and LineString geometries
-    queries.push_back("SELECT distinct(osm_id), refs, version, tags, uid, changeset FROM ways_poly WHERE refs && '{" + nodeIds + "}';");
-    queries.push_back("SELECT distinct(osm_id), refs, version, tags, uid, changeset FROM ways_line WHERE refs && '{" + nodeIds + "}';");
-
-    for (auto it = queries.begin(); it != queries.end(); ++it) {
-
-        auto ways_result = dbconn->query(*it);
-        if (ways_result.size() == 0) {
-            log_debug("No results returned!");
-            return ways;
-        }
-
-        // Create Ways objects and fill the vector
-        for (auto way_it = ways_result.begin(); way_it != ways_result.end(); ++way_it) {
-            auto way = std::make_shared<OsmWay>();
-            way->id = (*way_it)[0].as<long>();
-
-            std::string refs_str = (*way_it)[1].as<std::string>();
-            if (refs_str.size() > 1) {
-                way->refs = utils->arrayStrToVector(refs_str);
-            }
-            way->version = (*way_it)[2].as<long>();
-            auto tags = (*way_it)[3];
-            if (!tags.is_null()) {
-                auto tags = utils->parseJSONObjectStr((*way_it)[3].as<std::string>());
-                for (auto const& [key, val] : tags) {
-                    way->addTag(key, val);
-                }
-            }
-            auto uid = (*way_it)[4];
-            if (!uid.is_null()) {
-                way->uid = (*way_it)[4].as<long>();
-            }
-            auto changeset = (*way_it)[5];
-            if (!changeset.is_null()) {
-                way->changeset = (*way_it)[5].as<long>();
-            }
-            ways.push_back(way);
-        }
-    }
-    return ways;
-}
-
 // Utility functions
 
 // Returns latest timestamp from DB - 5 hours
@@ -626,6 +736,34 @@ QueryRaw::getLatestTimestamp() {
     return utils->cleanTimeStr(result[0][0].as<std::string>());
 }
 
+boost::posix_time::ptime
+QueryRaw::getNewestTimestamp() {
+    auto result = dbconn->query("SELECT MAX(max_timestamp) FROM ( \
+        SELECT MAX(timestamp) AS max_timestamp FROM nodes \
+        UNION ALL \
+        SELECT MAX(timestamp) FROM ways_line \
+        UNION ALL \
+        SELECT MAX(timestamp) FROM ways_poly \
+        UNION ALL \
+        SELECT MAX(timestamp) FROM relations \
+        ) AS combined;");
+    if (result.empty() || result[0][0].is_null()) {
+        return boost::posix_time::not_a_date_time;
+    }
+    return utils->cleanTimeStr(result[0][0].as<std::string>());
+}
+
+std::string
+QueryRaw::getDatabaseId() {
+    // The system identifier is different for every cluster, a database
+    // restored from a dump somewhere else doesn't match
+    auto result = dbconn->query("SELECT system_identifier::text || '/' || current_database() FROM pg_control_system();");
+    if (result.empty() || result[0][0].is_null()) {
+        return "";
+    }
+    return result[0][0].as<std::string>();
+}
+
 } // namespace queryraw
 
 // local Variables:
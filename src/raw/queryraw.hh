@@ -63,6 +63,10 @@ class QueryRaw {
     static const std::string polyTable;
     // Name of the table for storing linestrings
     static const std::string lineTable;
+    // Name of the table for the Nodes referenced by Ways
+    static const std::string wayRefsTable;
+    // Name of the table for the members of Relations
+    static const std::string relationMembersTable;
 
     // Data utils
     std::shared_ptr<DataUtils> utils;
@@ -70,20 +74,79 @@ class QueryRaw {
     // OSM DB connection
     std::shared_ptr<Pq> dbconn;
 
+    /// Create and fill the tables added after the database was created,
+    /// returns false if they can't be used
+    bool migrate(void);
+
     /// Build queries for apply changes to OSM features into DB
     std::shared_ptr<std::vector<std::string>> applyChange(const OsmNode &node) const;
     std::shared_ptr<std::vector<std::string>> applyChange(const OsmWay &way) const;
     std::shared_ptr<std::vector<std::string>> applyChange(const OsmRelation &relation) const;
 
+    /// Check the geometry of a Way matches its refs, so it can be stored
+    static bool validGeometry(const OsmWay &way);
+
+    /// \struct ContextIds
+    /// \brief The ids of a change that getContext() looks up
+    struct ContextIds {
+        std::vector<long> modifiedNodes;    ///< Nodes whose Ways are indirectly modified
+        std::vector<long> skipWays;         ///< Ways that aren't indirectly modified
+        std::vector<long> modifiedWays;     ///< Ways modified by the change
+        std::vector<long> skipRelations;    ///< Relations that aren't indirectly modified
+        std::vector<long> memberWays;       ///< Way members of the Relations of the change
+        std::vector<long> nodes;            ///< Nodes referenced by the Ways of the change
+        bool refNodes = true;               ///< Also get the Nodes of the indirectly modified Ways
+        bool empty(void) const {
+            return modifiedNodes.empty() && modifiedWays.empty() && memberWays.empty() && nodes.empty();
+        };
+    };
+
+    /// \struct Context
+    /// \brief What is needed from the DB to build the geometries of a change
+    struct Context {
+        std::vector<std::shared_ptr<OsmWay>> ways;              ///< Indirectly modified Ways
+        std::vector<std::shared_ptr<OsmRelation>> relations;    ///< Indirectly modified Relations
+        std::vector<std::shared_ptr<OsmNode>> nodes;            ///< Locations of the Nodes
+        std::vector<std::shared_ptr<OsmWay>> geometries;        ///< Geometries of the modified and member Ways
+    };
+
+    /// Get the context of a change in a single query. That's the Ways with
+    /// refs to the modified Nodes and the Relations with them or the modified
+    /// Ways as members, skipping the ones in the change, the geometries of
+    /// all those Ways and of the members of the Relations, and the locations
+    /// of the Nodes.
+    virtual Context getContext(const ContextIds &ids) const;
+
     // Get OSM features from DB
-    virtual std::vector<std::shared_ptr<osmobjects::OsmRelation>> getRelationsByWaysRefs(const std::string &wayIds) const;
-    virtual std::vector<std::shared_ptr<osmobjects::OsmWay>> getWaysByIds(const std::string &waysIds) const;
-    virtual std::vector<std::shared_ptr<osmobjects::OsmNode>> getNodesByIds(const std::string &nodeIds) const;
+    virtual std::vector<std::shared_ptr<osmobjects::OsmWay>> getWaysByIds(const std::vector<long> &waysIds) const;
+    virtual std::vector<std::shared_ptr<osmobjects::OsmNode>> getNodesByIds(const std::vector<long> &nodeIds) const;
     std::vector<std::shared_ptr<osmobjects::OsmNode>> getNodesFromWays(const std::shared_ptr<std::vector<OsmWay>> &ways) const;
-    virtual std::vector<std::shared_ptr<osmobjects::OsmWay>> getWaysByNodesRefs(const std::string &nodeIds) const;
+
+    // Largest number of ids sent in a single query, bigger sets are split
+    static const std::size_t maxIdsPerQuery;
+    /// Run a prepared statement taking an array of ids, in chunks of maxIdsPerQuery
+    std::vector<pqxx::result> queryIds(const std::string &statement, const std::vector<long> &ids) const;
 
     // Get latest timestamp from DB
     boost::posix_time::ptime getLatestTimestamp(void);
+    /// The timestamp of the newest object in the raw tables, or
+    /// not_a_date_time if they are empty
+    boost::posix_time::ptime getNewestTimestamp(void);
+    /// Identify the database, to tell it apart from other ones
+    std::string getDatabaseId(void);
+
+  private:
+    /// Create a table if it doesn't exist, and run the statements that
+    /// fill it if it's empty, in a single transaction
+    bool migrateTable(const std::string &table, const std::string &create,
+                      const std::vector<std::string> &fill);
+    /// Read a Way or a Relation from the osm_id, refs, version, tags, uid
+    /// and changeset columns of a row
+    std::shared_ptr<OsmWay> readWay(const pqxx::row &row) const;
+    std::shared_ptr<OsmRelation> readRelation(const pqxx::row &row) const;
+    /// Read the refs and the geometry of a Way from the osm_id, refs, geom
+    /// and kind columns of a row, nullptr if the geometry isn't valid
+    std::shared_ptr<OsmWay> readGeometry(const pqxx::row &row) const;
 
 };
 
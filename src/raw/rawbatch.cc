@@ -0,0 +1,395 @@
+//
+// Copyright (c) 2025 Emilio Mariscal
+//
+// This file is part of Underpass.
+//
+//     Underpass is free software: you can redistribute it and/or modify
+//     it under the terms of the GNU General Public License as published by
+//     the Free Software Foundation, either version 3 of the License, or
+//     (at your option) any later version.
+//
+//     Underpass is distributed in the hope that it will be useful,
+//     but WITHOUT ANY WARRANTY; without even the implied warranty of
+//     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//     GNU General Public License for more details.
+//
+//     You should have received a copy of the GNU General Public License
+//     along with Underpass.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+// This is generated by autoconf
+#ifdef HAVE_CONFIG_H
+#include "unconfig.h"
+#endif
+
+#include <optional>
+#include <boost/date_time/posix_time/posix_time.hpp>
+#include "utils/log.hh"
+#include "raw/rawbatch.hh"
+#include "raw/queryraw.hh"
+#include "raw/wkb.hh"
+
+using namespace logger;
+using namespace datautils;
+namespace bg = boost::geometry;
+
+/// \namespace queryraw
+namespace queryraw {
+
+// The staging tables are created once on every connection, and emptied
+// when the transaction ends
+static const std::string stagingTables =
+    "SET LOCAL client_min_messages = warning;"
+    "CREATE TEMP TABLE IF NOT EXISTS stage_nodes (osm_id int8, action char(1), poly bool, moved bool, geom geometry, "
+    "tags jsonb, timestamp timestamp with time zone, version int, \"user\" text, uid int8, changeset int8) ON COMMIT DELETE ROWS;"
+    "CREATE TEMP TABLE IF NOT EXISTS stage_ways (osm_id int8, action char(1), poly bool, moved bool, geom geometry, "
+    "tags jsonb, refs int8[], timestamp timestamp with time zone, version int, \"user\" text, uid int8, changeset int8) ON COMMIT DELETE ROWS;"
+    "CREATE TEMP TABLE IF NOT EXISTS stage_relations (osm_id int8, action char(1), poly bool, moved bool, geom geometry, "
+    "tags jsonb, refs jsonb, timestamp timestamp with time zone, version int, \"user\" text, uid int8, changeset int8) ON COMMIT DELETE ROWS;";
+
+// Nodes are only replaced by a newer version. Rows are inserted in id
+// order, so the rows of each partition of a table are written together.
+static const std::string applyNodes =
+    "DELETE FROM nodes AS n USING stage_nodes AS s WHERE n.osm_id = s.osm_id AND s.action IN ('d', 'r');"
+    "INSERT INTO nodes AS r (osm_id, geom, tags, timestamp, version, \"user\", uid, changeset) "
+    "SELECT osm_id, geom, tags, timestamp, version, \"user\", uid, changeset FROM stage_nodes WHERE action IN ('u', 'r') ORDER BY osm_id "
+    "ON CONFLICT (osm_id) DO UPDATE SET geom = EXCLUDED.geom, tags = EXCLUDED.tags, timestamp = EXCLUDED.timestamp, "
+    "version = EXCLUDED.version, \"user\" = EXCLUDED.\"user\", uid = EXCLUDED.uid, changeset = EXCLUDED.changeset "
+    "WHERE r.version < EXCLUDED.version;";
+
+// A Way is removed from the table of the other type of geometry, and the
+// reverse index is rebuilt from the refs that were actually stored
+static std::string
+applyWays(void)
+{
+    std::string sql;
+    for (const auto *table : {&QueryRaw::polyTable, &QueryRaw::lineTable}) {
+        const bool isPoly = table == &QueryRaw::polyTable;
+        const std::string poly = isPoly ? "s.poly" : "NOT s.poly";
+        const std::string other = isPoly ? "NOT s.poly" : "s.poly";
+        sql += "DELETE FROM " + *table + " AS w USING stage_ways AS s WHERE w.osm_id = s.osm_id "
+            "AND (s.action IN ('d', 'r') OR (s.moved AND " + other + "));";
+        sql += "INSERT INTO " + *table + " AS r (osm_id, tags, refs, geom, timestamp, version, \"user\", uid, changeset) "
+            "SELECT osm_id, tags, refs, geom, timestamp, version, \"user\", uid, changeset FROM stage_ways AS s "
+            "WHERE s.action IN ('u', 'r') AND " + poly + " ORDER BY osm_id "
+            "ON CONFLICT (osm_id) DO UPDATE SET tags = EXCLUDED.tags, refs = EXCLUDED.refs, geom = EXCLUDED.geom, "
+            "timestamp = EXCLUDED.timestamp, version = EXCLUDED.version, \"user\" = EXCLUDED.\"user\", "
+            "uid = EXCLUDED.uid, changeset = EXCLUDED.changeset WHERE r.version <= EXCLUDED.version;";
+        sql += "UPDATE " + *table + " AS w SET geom = s.geom, timestamp = s.timestamp FROM stage_ways AS s "
+            "WHERE w.osm_id = s.osm_id AND s.action = 'g' AND " + poly + ";";
+    }
+    sql += "DELETE FROM " + QueryRaw::wayRefsTable + " AS w USING stage_ways AS s WHERE w.way_id = s.osm_id AND s.action <> 'g';";
+    sql += "INSERT INTO " + QueryRaw::wayRefsTable + " (way_id, node_id) SELECT DISTINCT w.osm_id, unnest(w.refs) "
+        "FROM (SELECT osm_id, refs FROM " + QueryRaw::polyTable + " UNION ALL SELECT osm_id, refs FROM " + QueryRaw::lineTable + ") AS w "
+        "JOIN stage_ways AS s ON w.osm_id = s.osm_id WHERE s.action IN ('u', 'r') ON CONFLICT DO NOTHING;";
+    return sql;
+}
+
+static std::string
+applyRelations(void)
+{
+    return "DELETE FROM relations AS r USING stage_relations AS s WHERE r.osm_id = s.osm_id AND s.action IN ('d', 'r');"
+        "DELETE FROM " + QueryRaw::relationMembersTable + " AS m USING stage_relations AS s "
+        "WHERE m.relation_id = s.osm_id AND s.action <> 'g';"
+        "INSERT INTO relations AS r (osm_id, tags, refs, geom, timestamp, version, \"user\", uid, changeset) "
+        "SELECT osm_id, tags, refs, geom, timestamp, version, \"user\", uid, changeset FROM stage_relations WHERE action IN ('u', 'r') ORDER BY osm_id "
+        "ON CONFLICT (osm_id) DO UPDATE SET tags = EXCLUDED.tags, refs = EXCLUDED.refs, geom = EXCLUDED.geom, "
+        "timestamp = EXCLUDED.timestamp, version = EXCLUDED.version, \"user\" = EXCLUDED.\"user\", "
+        "uid = EXCLUDED.uid, changeset = EXCLUDED.changeset WHERE r.version <= EXCLUDED.version;"
+        "UPDATE relations AS r SET geom = s.geom, timestamp = s.timestamp FROM stage_relations AS s "
+        "WHERE r.osm_id = s.osm_id AND s.action = 'g';"
+        "INSERT INTO " + QueryRaw::relationMembersTable + " (relation_id, member_type, member_ref) "
+        "SELECT DISTINCT r.osm_id, left(m->>'type', 1), (m->>'ref')::int8 FROM relations AS r "
+        "JOIN stage_relations AS s ON r.osm_id = s.osm_id CROSS JOIN LATERAL jsonb_array_elements(r.refs) AS m "
+        "WHERE s.action IN ('u', 'r') AND m->>'type' <> '' ON CONFLICT DO NOTHING;";
+}
+
+// Fill the columns every type of object has
+static RawBatch::Row
+makeRow(const OsmObject &object, RawBatch::action_t action)
+{
+    RawBatch::Row row;
+    row.action = action;
+    if (object.timestamp != not_a_date_time) {
+        row.timestamp = to_iso_extended_string(object.timestamp);
+    } else {
+        row.timestamp = to_iso_extended_string(boost::posix_time::second_clock::universal_time());
+    }
+    row.version = object.version;
+    row.user = object.user;
+    row.uid = object.uid;
+    row.changeset = object.changeset;
+    return row;
+}
+
+void
+RawBatch::merge(IdMap<Row> &rows, long id, const Row &row, bool replaceEqual)
+{
+    auto current = rows.find(id);
+    if (!current) {
+        rows.insert(id, row);
+        return;
+    }
+    // The table a Way is stored in is the one before the batch, if an
+    // earlier change had another geometry the Way may be stored there
+    const bool moved = current->moved || row.moved || current->poly != row.poly;
+    switch (row.action) {
+        case remove:
+            *current = row;
+            break;
+        case upsert:
+            if (current->action == remove) {
+                *current = row;
+                current->action = replace;
+            } else if (current->action == geometry) {
+                *current = row;
+            } else if (current->version < row.version || (replaceEqual && current->version == row.version)) {
+                // The version check of the upsert, the row keeps its action
+                action_t action = current->action;
+                *current = row;
+                current->action = action;
+            }
+            break;
+        case geometry:
+            // Updating a deleted object does nothing
+            if (current->action != remove) {
+                current->poly = row.poly;
+                current->geom = row.geom;
+                current->timestamp = row.timestamp;
+            }
+            break;
+        default:
+            break;
+    }
+    current->moved = moved;
+}
+
+void
+RawBatch::add(const OsmNode &node)
+{
+    if (node.action == osmobjects::create || node.action == osmobjects::modify) {
+        Row row = makeRow(node, upsert);
+        wkb::EWKBWriter writer;
+        row.geom = writer.hex(node.point);
+        row.tags = DataUtils::buildTagsJSON(node.tags);
+        merge(nodes, node.id, row, false);
+    } else if (node.action == osmobjects::remove) {
+        merge(nodes, node.id, makeRow(node, remove), false);
+    }
+}
+
+void
+RawBatch::add(const OsmWay &way)
+{
+    if (way.action == osmobjects::create || way.action == osmobjects::modify
+        || way.action == osmobjects::modify_geom) {
+        if (!QueryRaw::validGeometry(way)) {
+            return;
+        }
+        Row row = makeRow(way, way.action == osmobjects::modify_geom ? geometry : upsert);
+        wkb::EWKBWriter writer;
+        row.poly = way.isClosed();
+        row.moved = way.mayChangeTable();
+        row.geom = row.poly ? writer.hex(way.polygon) : writer.hex(way.linestring);
+        if (row.action == upsert) {
+            row.tags = DataUtils::buildTagsJSON(way.tags);
+            row.refs = "{";
+            for (const auto ref : way.refs) {
+                row.refs += std::to_string(ref) + ",";
+            }
+            row.refs.back() = '}';
+        }
+        merge(ways, way.id, row, true);
+    } else if (way.action == osmobjects::remove) {
+        merge(ways, way.id, makeRow(way, remove), true);
+    }
+}
+
+void
+RawBatch::add(const OsmRelation &relation)
+{
+    if (relation.action == osmobjects::create || relation.action == osmobjects::modify
+        || relation.action == osmobjects::modify_geom) {
+        Row row = makeRow(relation, relation.action == osmobjects::modify_geom ? geometry : upsert);
+        wkb::EWKBWriter writer;
+        // Ignore empty geometries
+        if (relation.isMultiPolygon()) {
+            if (bg::num_points(relation.multipolygon) == 0) {
+                return;
+            }
+            // A single outer ring is stored as a Polygon
+            if (relation.multipolygon.size() == 1) {
+                row.geom = writer.hex(relation.multipolygon.front());
+            } else {
+                row.geom = writer.hex(relation.multipolygon);
+            }
+        } else {
+            if (bg::num_points(relation.multilinestring) == 0) {
+                return;
+            }
+            row.geom = writer.hex(relation.multilinestring);
+        }
+        if (row.action == upsert) {
+            row.tags = DataUtils::buildTagsJSON(relation.tags);
+            row.refs = DataUtils::buildMembersJSON(relation.members);
+        }
+        merge(relations, relation.id, row, true);
+    } else if (relation.action == osmobjects::remove) {
+        merge(relations, relation.id, makeRow(relation, remove), true);
+    }
+}
+
+void
+RawBatch::append(const RawBatch &batch)
+{
+    for (const auto &[id, row] : batch.nodes) {
+        merge(nodes, id, row, false);
+    }
+    for (const auto &[id, row] : batch.ways) {
+        merge(ways, id, row, true);
+    }
+    for (const auto &[id, row] : batch.relations) {
+        merge(relations, id, row, true);
+    }
+}
+
+void
+RawBatch::clear(void)
+{
+    nodes.clear();
+    ways.clear();
+    relations.clear();
+}
+
+// Start a COPY into a table. stream_to::raw_table() is only in libpqxx
+// 7.7 and later, older versions take the columns as a list of names,
+// both quote them.
+static pqxx::stream_to
+openStream(pqxx::work &worker, const std::string &table, const std::vector<std::string> &columns)
+{
+#if PQXX_VERSION_MAJOR > 7 || (PQXX_VERSION_MAJOR == 7 && PQXX_VERSION_MINOR >= 7)
+    std::string list;
+    for (const auto &column : columns) {
+        list += (list.empty() ? "" : ", ") + worker.quote_name(column);
+    }
+    return pqxx::stream_to::raw_table(worker, table, list);
+#else
+    return pqxx::stream_to(worker, table, columns);
+#endif
+}
+
+// Stream the rows into a staging table. Empty strings are written as NULL.
+static void
+copyRows(pqxx::work &worker, const std::string &table, const IdMap<RawBatch::Row> &rows, bool withRefs)
+{
+    auto optional = [](const std::string &value) {
+        return value.empty() ? std::nullopt : std::optional<std::string>(value);
+    };
+    const std::vector<std::string> columns = withRefs ?
+        std::vector<std::string>{"osm_id", "action", "poly", "moved", "geom", "tags", "refs", "timestamp", "version", "user", "uid", "changeset"} :
+        std::vector<std::string>{"osm_id", "action", "poly", "moved", "geom", "tags", "timestamp", "version", "user", "uid", "changeset"};
+    auto stream = openStream(worker, table, columns);
+    for (const auto &[id, row] : rows) {
+        const std::string action(1, row.action);
+        if (withRefs) {
+            stream.write_values(id, action, row.poly, row.moved, optional(row.geom), optional(row.tags), optional(row.refs),
+                                row.timestamp, row.version, row.user, row.uid, row.changeset);
+        } else {
+            stream.write_values(id, action, row.poly, row.moved, optional(row.geom), optional(row.tags),
+                                row.timestamp, row.version, row.user, row.uid, row.changeset);
+        }
+    }
+    stream.complete();
+}
+
+// Stream the rows straight into a raw table, the ones that are stored
+// there when a Way table is given
+static void
+loadRows(pqxx::work &worker, const std::string &table, const IdMap<RawBatch::Row> &rows, bool withRefs)
+{
+    auto optional = [](const std::string &value) {
+        return value.empty() ? std::nullopt : std::optional<std::string>(value);
+    };
+    const std::vector<std::string> columns = withRefs ?
+        std::vector<std::string>{"osm_id", "geom", "tags", "refs", "timestamp", "version", "user", "uid", "changeset"} :
+        std::vector<std::string>{"osm_id", "geom", "tags", "timestamp", "version", "user", "uid", "changeset"};
+    const bool poly = table == QueryRaw::polyTable;
+    const bool ways = poly || table == QueryRaw::lineTable;
+    auto stream = openStream(worker, "public." + table, columns);
+    for (const auto &[id, row] : rows) {
+        if ((ways && row.poly != poly) || (row.action != RawBatch::upsert && row.action != RawBatch::replace)) {
+            continue;
+        }
+        if (withRefs) {
+            stream.write_values(id, optional(row.geom), optional(row.tags), optional(row.refs),
+                                row.timestamp, row.version, row.user, row.uid, row.changeset);
+        } else {
+            stream.write_values(id, optional(row.geom), optional(row.tags),
+                                row.timestamp, row.version, row.user, row.uid, row.changeset);
+        }
+    }
+    stream.complete();
+}
+
+void
+RawBatch::load(pqxx::work &worker) const
+{
+    if (!nodes.empty()) {
+        loadRows(worker, "nodes", nodes, false);
+    }
+    if (!ways.empty()) {
+        loadRows(worker, QueryRaw::polyTable, ways, true);
+        loadRows(worker, QueryRaw::lineTable, ways, true);
+    }
+    if (!relations.empty()) {
+        loadRows(worker, "relations", relations, true);
+    }
+}
+
+bool
+RawBatch::apply(Pq &db) const
+{
+    if (empty()) {
+        return true;
+    }
+    bool applied = false;
+    db.execute("batch of changes", [this, &applied](Pq::Lease &conn) {
+        pqxx::work worker(*conn);
+        write(worker);
+        worker.commit();
+        applied = true;
+        return pqxx::result();
+    });
+    return applied;
+}
+
+void
+RawBatch::write(pqxx::work &worker) const
+{
+    if (empty()) {
+        return;
+    }
+    log_debug("Apply %1% nodes, %2% ways and %3% relations", nodes.size(), ways.size(), relations.size());
+    worker.exec(stagingTables);
+    std::string sql;
+    if (!nodes.empty()) {
+        copyRows(worker, "stage_nodes", nodes, false);
+        sql += applyNodes;
+    }
+    if (!ways.empty()) {
+        copyRows(worker, "stage_ways", ways, true);
+        sql += applyWays();
+    }
+    if (!relations.empty()) {
+        copyRows(worker, "stage_relations", relations, true);
+        sql += applyRelations();
+    }
+    worker.exec(sql);
+}
+
+} // namespace queryraw
+
+// local Variables:
+// mode: C++
+// indent-tabs-mode: nil
+// End:
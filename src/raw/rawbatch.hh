@@ -0,0 +1,119 @@
+//
+// Copyright (c) 2025 Emilio Mariscal
+//
+// This file is part of Underpass.
+//
+//     Underpass is free software: you can redistribute it and/or modify
+//     it under the terms of the GNU General Public License as published by
+//     the Free Software Foundation, either version 3 of the License, or
+//     (at your option) any later version.
+//
+//     Underpass is distributed in the hope that it will be useful,
+//     but WITHOUT ANY WARRANTY; without even the implied warranty of
+//     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//     GNU General Public License for more details.
+//
+//     You should have received a copy of the GNU General Public License
+//     along with Underpass.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#ifndef __RAWBATCH_HH__
+#define __RAWBATCH_HH__
+
+/// \file rawbatch.hh
+/// \brief Apply a batch of changes to the raw tables with COPY
+///
+/// Instead of an INSERT ... ON CONFLICT statement for every object, the
+/// changed objects are streamed with COPY into temporary staging tables,
+/// and each target table is updated with a few set-based statements. The
+/// version checks are the same as the ones in QueryRaw::applyChange().
+
+// This is generated by autoconf
+#ifdef HAVE_CONFIG_H
+#include "unconfig.h"
+#endif
+
+#include <string>
+#include "data/pq.hh"
+#include "osm/osmobjects.hh"
+#include "osm/idmap.hh"
+
+using namespace pq;
+using namespace osmobjects;
+
+/// \namespace queryraw
+namespace queryraw {
+
+/// \class RawBatch
+/// \brief Changes to the raw tables, applied in a single transaction
+///
+/// There is one row for every object. Changes to an object that is already
+/// in the batch are merged, the same way the statements would have been
+/// applied one after the other, so the staging tables never have two rows
+/// for the same id.
+class RawBatch {
+  public:
+    /// What is done with a row
+    enum action_t : char {
+        upsert = 'u',    ///< Insert, or update an older version
+        replace = 'r',   ///< Delete, then insert
+        geometry = 'g',  ///< Update only the geometry and timestamp
+        remove = 'd'     ///< Delete
+    };
+
+    /// A row of a staging table
+    struct Row {
+        action_t action;
+        bool poly = false;       ///< The Way is stored as a Polygon
+        bool moved = false;      ///< The Way may be stored in the table of the other geometry
+        std::string geom;        ///< Hex EWKB
+        std::string tags;        ///< JSON, empty for NULL
+        std::string refs;        ///< Refs of a Way or JSON members of a Relation
+        std::string timestamp;
+        long version = 0;
+        std::string user;
+        long uid = 0;
+        long changeset = 0;
+    };
+
+    /// Add the change of an object, ignoring the ones that
+    /// QueryRaw::applyChange() would ignore
+    void add(const OsmNode &node);
+    void add(const OsmWay &way);
+    void add(const OsmRelation &relation);
+
+    /// Add the changes of another batch, which come after these
+    void append(const RawBatch &batch);
+
+    std::size_t size(void) const { return nodes.size() + ways.size() + relations.size(); };
+    bool empty(void) const { return size() == 0; };
+    void clear(void);
+
+    /// Write the changes to the database, returns false if the
+    /// transaction failed
+    bool apply(Pq &db) const;
+    /// Write the changes in a transaction, which is committed by the caller
+    void write(pqxx::work &worker) const;
+    /// Write the new objects straight into the tables, for a bulk import
+    /// into tables without constraints. The reverse indexes of refs and
+    /// members aren't updated, and deletes are ignored.
+    void load(pqxx::work &worker) const;
+
+  private:
+    IdMap<Row> nodes;
+    IdMap<Row> ways;
+    IdMap<Row> relations;
+
+    /// Merge a row with the one already in the batch for the same id.
+    /// replaceEqual is true when the same version replaces the stored one.
+    static void merge(IdMap<Row> &rows, long id, const Row &row, bool replaceEqual);
+};
+
+} // namespace queryraw
+
+#endif // EOF __RAWBATCH_HH__
+
+// local Variables:
+// mode: C++
+// indent-tabs-mode: nil
+// End:
@@ -0,0 +1,192 @@
+//
+// Copyright (c) 2025 Emilio Mariscal
+//
+// This file is part of Underpass.
+//
+//     Underpass is free software: you can redistribute it and/or modify
+//     it under the terms of the GNU General Public License as published by
+//     the Free Software Foundation, either version 3 of the License, or
+//     (at your option) any later version.
+//
+//     Underpass is distributed in the hope that it will be useful,
+//     but WITHOUT ANY WARRANTY; without even the implied warranty of
+//     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//     GNU General Public License for more details.
+//
+//     You should have received a copy of the GNU General Public License
+//     along with Underpass.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+// This is generated by autoconf
+#ifdef HAVE_CONFIG_H
+#include "unconfig.h"
+#endif
+
+#include <algorithm>
+#include <chrono>
+#include "utils/log.hh"
+#include "raw/rawwriter.hh"
+
+using namespace logger;
+
+/// \namespace queryraw
+namespace queryraw {
+
+RawWriter::RawWriter(std::shared_ptr<Pq> db, std::size_t maxGroup)
+    : db(db), maxGroup(std::max<std::size_t>(maxGroup, 1))
+{
+    thread = std::thread(&RawWriter::run, this);
+}
+
+RawWriter::~RawWriter(void)
+{
+    {
+        std::scoped_lock lock{mutex};
+        stopping = true;
+    }
+    changed.notify_all();
+    thread.join();
+}
+
+void
+RawWriter::push(const std::string &name, RawBatch batch, std::string queries,
+                std::function<void(void)> committed)
+{
+    // A file without changes is still queued if something waits for it,
+    // so it isn't reported before the files pushed earlier
+    if (batch.empty() && queries.empty() && !committed) {
+        return;
+    }
+    {
+        std::unique_lock lock{mutex};
+        // Keep the memory bounded if the database is slower than the files
+        changed.wait(lock, [this] { return queue.size() < maxGroup * 2; });
+        queue.push_back({name, std::move(batch), std::move(queries), std::move(committed)});
+    }
+    changed.notify_all();
+}
+
+void
+RawWriter::flush(void)
+{
+    std::unique_lock lock{mutex};
+    changed.wait(lock, [this] { return queue.empty() && !writing; });
+}
+
+RawWriter::Stats
+RawWriter::stats(void)
+{
+    std::scoped_lock lock{mutex};
+    Stats current = counters;
+    current.queued = queue.size();
+    return current;
+}
+
+void
+RawWriter::run(void)
+{
+    while (true) {
+        std::vector<File> files;
+        {
+            std::unique_lock lock{mutex};
+            changed.wait(lock, [this] { return !queue.empty() || stopping; });
+            if (queue.empty()) {
+                return;
+            }
+            // Everything that is waiting goes in the same transaction
+            while (!queue.empty() && files.size() < maxGroup) {
+                files.push_back(std::move(queue.front()));
+                queue.pop_front();
+            }
+            writing = true;
+        }
+        changed.notify_all();
+
+        std::size_t failed = 0;
+        if (commit(files)) {
+            for (const auto &file : files) {
+                notify(file);
+            }
+        } else if (files.size() == 1) {
+            log_error("Couldn't write the changes of %1%", files.front().name);
+            failed = 1;
+        } else {
+            log_error("Couldn't write %1% files together, writing them one by one", files.size());
+            for (const auto &file : files) {
+                if (commit({file})) {
+                    notify(file);
+                } else {
+                    log_error("Couldn't write the changes of %1%", file.name);
+                    ++failed;
+                }
+            }
+        }
+        {
+            std::scoped_lock lock{mutex};
+            counters.files += files.size();
+            counters.failed += failed;
+            writing = false;
+        }
+        changed.notify_all();
+    }
+}
+
+bool
+RawWriter::commit(const std::vector<File> &files)
+{
+    // The batches are merged, so the rows of the same object are written once
+    RawBatch batch;
+    std::string queries;
+    for (const auto &file : files) {
+        batch.append(file.batch);
+        queries += file.queries;
+    }
+
+    if (batch.empty() && queries.empty()) {
+        return true;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    bool committed = false;
+    db->execute("changes of " + files.front().name, [&](Pq::Lease &conn) {
+        pqxx::work worker(*conn);
+        batch.write(worker);
+        if (!queries.empty()) {
+            worker.exec(queries);
+        }
+        worker.commit();
+        committed = true;
+        return pqxx::result();
+    });
+    std::chrono::duration<double> latency = std::chrono::steady_clock::now() - start;
+    if (!committed) {
+        return false;
+    }
+
+    log_debug("Committed %1% files, %2% objects in %3% seconds", files.size(), batch.size(), latency.count());
+    std::scoped_lock lock{mutex};
+    ++counters.commits;
+    counters.totalLatency += latency.count();
+    counters.maxLatency = std::max(counters.maxLatency, latency.count());
+    return true;
+}
+
+void
+RawWriter::notify(const File &file)
+{
+    if (!file.committed) {
+        return;
+    }
+    try {
+        file.committed();
+    } catch (const std::exception &e) {
+        log_error("After writing the changes of %1%: %2%", file.name, e.what());
+    }
+}
+
+} // namespace queryraw
+
+// local Variables:
+// mode: C++
+// indent-tabs-mode: nil
+// End:
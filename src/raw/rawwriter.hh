@@ -0,0 +1,127 @@
+//
+// Copyright (c) 2025 Emilio Mariscal
+//
+// This file is part of Underpass.
+//
+//     Underpass is free software: you can redistribute it and/or modify
+//     it under the terms of the GNU General Public License as published by
+//     the Free Software Foundation, either version 3 of the License, or
+//     (at your option) any later version.
+//
+//     Underpass is distributed in the hope that it will be useful,
+//     but WITHOUT ANY WARRANTY; without even the implied warranty of
+//     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//     GNU General Public License for more details.
+//
+//     You should have received a copy of the GNU General Public License
+//     along with Underpass.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#ifndef __RAWWRITER_HH__
+#define __RAWWRITER_HH__
+
+/// \file rawwriter.hh
+/// \brief Write the changes of replication files in the background
+///
+/// The changes of every file are queued, and written by a thread with its
+/// own database connection, so the next files can be downloaded and parsed
+/// while the previous ones are committed.
+
+// This is generated by autoconf
+#ifdef HAVE_CONFIG_H
+#include "unconfig.h"
+#endif
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "data/pq.hh"
+#include "raw/rawbatch.hh"
+
+using namespace pq;
+
+/// \namespace queryraw
+namespace queryraw {
+
+/// \class RawWriter
+/// \brief Commits the changes of replication files, in order
+///
+/// The files waiting in the queue are committed together in a single
+/// transaction, up to maxGroup files. If the transaction fails, the
+/// files are committed one by one, so a bad file doesn't lose the
+/// changes of the others.
+///
+/// A file is never held back to wait for more. Geometries are built
+/// from the database, so the next file can't be processed until the
+/// previous one is committed, and once caught up every minutely file
+/// is committed on its own.
+class RawWriter {
+  public:
+    /// \struct Stats
+    /// \brief Commits done so far, and how long they took
+    struct Stats {
+        std::size_t commits = 0;
+        std::size_t files = 0;
+        std::size_t failed = 0;     ///< Files that couldn't be written
+        double totalLatency = 0;    ///< Seconds, from the start of the transaction to the commit
+        double maxLatency = 0;
+        std::size_t queued = 0;     ///< Files waiting in the queue
+    };
+
+    /// The connection must not be shared with other threads
+    RawWriter(std::shared_ptr<Pq> db, std::size_t maxGroup = 16);
+    /// Writes what is left in the queue before returning
+    ~RawWriter(void);
+    RawWriter(const RawWriter &) = delete;
+    RawWriter &operator=(const RawWriter &) = delete;
+
+    /// Queue the changes of a file, as a batch or as SQL statements.
+    /// Waits if the writer is too far behind. The committed function is
+    /// called by the writer thread once the changes are in the database,
+    /// in the same order as the files were pushed.
+    void push(const std::string &name, RawBatch batch, std::string queries,
+              std::function<void(void)> committed = nullptr);
+    /// Wait until everything in the queue is committed
+    void flush(void);
+
+    /// The counters since the writer started, and the queue depth
+    Stats stats(void);
+
+  private:
+    struct File {
+        std::string name;
+        RawBatch batch;
+        std::string queries;
+        std::function<void(void)> committed;
+    };
+
+    std::shared_ptr<Pq> db;
+    std::size_t maxGroup;
+    std::deque<File> queue;
+    bool writing = false;   ///< Files were taken from the queue and aren't committed yet
+    bool stopping = false;
+    Stats counters;
+    std::mutex mutex;
+    std::condition_variable changed;
+    std::thread thread;
+
+    void run(void);
+    /// Write some files in a single transaction
+    bool commit(const std::vector<File> &files);
+    /// Call the function waiting for a file that was committed
+    void notify(const File &file);
+};
+
+} // namespace queryraw
+
+#endif // EOF __RAWWRITER_HH__
+
+// local Variables:
+// mode: C++
+// indent-tabs-mode: nil
+// End:
@@ -0,0 +1,345 @@
+//
+// Copyright (c) 2025 Emilio Mariscal
+//
+// This file is part of Underpass.
+//
+//     Underpass is free software: you can redistribute it and/or modify
+//     it under the terms of the GNU General Public License as published by
+//     the Free Software Foundation, either version 3 of the License, or
+//     (at your option) any later version.
+//
+//     Underpass is distributed in the hope that it will be useful,
+//     but WITHOUT ANY WARRANTY; without even the implied warranty of
+//     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//     GNU General Public License for more details.
+//
+//     You should have received a copy of the GNU General Public License
+//     along with Underpass.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+// This is generated by autoconf
+#ifdef HAVE_CONFIG_H
+#include "unconfig.h"
+#endif
+
+#include <cstring>
+
+#include "raw/wkb.hh"
+
+namespace wkb {
+
+// Geometry types, and the flag PostGIS uses for a geometry with a SRID
+static const uint32_t wkbPoint = 1;
+static const uint32_t wkbLineString = 2;
+static const uint32_t wkbPolygon = 3;
+static const uint32_t wkbMultiLineString = 5;
+static const uint32_t wkbMultiPolygon = 6;
+static const uint32_t ewkbSrid = 0x20000000;
+
+static const char *hexDigits = "0123456789ABCDEF";
+
+// Append a value as little endian hex, whatever the byte order of the host
+static inline void
+appendHex(std::string &data, uint64_t value, int bytes)
+{
+    for (int i = 0; i < bytes; ++i) {
+        data.push_back(hexDigits[(value >> 4) & 0xf]);
+        data.push_back(hexDigits[value & 0xf]);
+        value >>= 8;
+    }
+}
+
+void
+EWKBWriter::uint32(uint32_t value)
+{
+    appendHex(data, value, 4);
+}
+
+void
+EWKBWriter::header(uint32_t type, bool withSrid)
+{
+    // Byte order, 1 is little endian
+    appendHex(data, 1, 1);
+    if (withSrid) {
+        uint32(type | ewkbSrid);
+        uint32(srid);
+    } else {
+        uint32(type);
+    }
+}
+
+void
+EWKBWriter::point(const point_t &point)
+{
+    uint64_t x, y;
+    double lon = point.get<0>();
+    double lat = point.get<1>();
+    std::memcpy(&x, &lon, sizeof(x));
+    std::memcpy(&y, &lat, sizeof(y));
+    appendHex(data, x, 8);
+    appendHex(data, y, 8);
+}
+
+template <typename T>
+void
+EWKBWriter::points(const T &range)
+{
+    uint32(range.size());
+    for (const auto &p : range) {
+        point(p);
+    }
+}
+
+void
+EWKBWriter::rings(const polygon_t &polygon)
+{
+    // An empty Polygon has no rings at all
+    if (polygon.outer().empty()) {
+        uint32(0);
+        return;
+    }
+    uint32(polygon.inners().size() + 1);
+    points(polygon.outer());
+    for (const auto &inner : polygon.inners()) {
+        points(inner);
+    }
+}
+
+std::string
+EWKBWriter::hex(const point_t &geometry)
+{
+    data.clear();
+    header(wkbPoint, true);
+    point(geometry);
+    return data;
+}
+
+std::string
+EWKBWriter::hex(const linestring_t &linestring)
+{
+    data.clear();
+    data.reserve(18 + linestring.size() * 32);
+    header(wkbLineString, true);
+    points(linestring);
+    return data;
+}
+
+std::string
+EWKBWriter::hex(const polygon_t &polygon)
+{
+    data.clear();
+    data.reserve(26 + boost::geometry::num_points(polygon) * 32);
+    header(wkbPolygon, true);
+    rings(polygon);
+    return data;
+}
+
+std::string
+EWKBWriter::hex(const multilinestring_t &multilinestring)
+{
+    data.clear();
+    data.reserve(26 + boost::geometry::num_points(multilinestring) * 32);
+    header(wkbMultiLineString, true);
+    uint32(multilinestring.size());
+    // The SRID is only written once, for the collection
+    for (const auto &linestring : multilinestring) {
+        header(wkbLineString, false);
+        points(linestring);
+    }
+    return data;
+}
+
+std::string
+EWKBWriter::hex(const multipolygon_t &multipolygon)
+{
+    data.clear();
+    data.reserve(26 + boost::geometry::num_points(multipolygon) * 32);
+    header(wkbMultiPolygon, true);
+    uint32(multipolygon.size());
+    for (const auto &polygon : multipolygon) {
+        header(wkbPolygon, false);
+        rings(polygon);
+    }
+    return data;
+}
+
+static inline int
+hexValue(char c)
+{
+    if (c >= '0' && c <= '9') {
+        return c - '0';
+    } else if (c >= 'A' && c <= 'F') {
+        return c - 'A' + 10;
+    } else if (c >= 'a' && c <= 'f') {
+        return c - 'a' + 10;
+    }
+    return -1;
+}
+
+void
+EWKBReader::start(std::string_view hex)
+{
+    // bytea values come with a \x prefix
+    if (hex.size() >= 2 && hex[0] == '\\' && hex[1] == 'x') {
+        hex.remove_prefix(2);
+    }
+    data = hex;
+    pos = 0;
+    valid = true;
+}
+
+uint64_t
+EWKBReader::value(int bytes)
+{
+    if (!valid || data.size() - pos < static_cast<std::size_t>(bytes) * 2) {
+        valid = false;
+        return 0;
+    }
+    uint64_t result = 0;
+    for (int i = 0; i < bytes; ++i) {
+        int high = hexValue(data[pos++]);
+        int low = hexValue(data[pos++]);
+        if (high < 0 || low < 0) {
+            valid = false;
+            return 0;
+        }
+        uint64_t byte = (high << 4) | low;
+        if (littleEndian) {
+            result |= byte << (i * 8);
+        } else {
+            result = (result << 8) | byte;
+        }
+    }
+    return result;
+}
+
+void
+EWKBReader::header(uint32_t type)
+{
+    // The byte order is read as a single byte, so it doesn't depend on itself
+    auto order = value(1);
+    if (order > 1) {
+        valid = false;
+        return;
+    }
+    littleEndian = order == 1;
+    uint32_t geomtype = uint32();
+    if (geomtype & ewkbSrid) {
+        uint32();
+    }
+    // Only 2D geometries, without the Z and M flags of EWKB
+    if ((geomtype & ~ewkbSrid) != type) {
+        valid = false;
+    }
+}
+
+point_t
+EWKBReader::point(void)
+{
+    uint64_t x = value(8);
+    uint64_t y = value(8);
+    double lon, lat;
+    std::memcpy(&lon, &x, sizeof(lon));
+    std::memcpy(&lat, &y, sizeof(lat));
+    return point_t(lon, lat);
+}
+
+// Read the number of elements that follow, checking they fit in the rest
+// of the data, so a corrupt count can't make us allocate gigabytes
+uint32_t
+EWKBReader::count(std::size_t minBytes)
+{
+    uint32_t size = uint32();
+    if (valid && (data.size() - pos) / 2 / minBytes < size) {
+        valid = false;
+        return 0;
+    }
+    return size;
+}
+
+template <typename T>
+void
+EWKBReader::points(T &range)
+{
+    uint32_t size = count(16);
+    range.clear();
+    range.reserve(size);
+    for (uint32_t i = 0; valid && i < size; ++i) {
+        range.push_back(point());
+    }
+}
+
+void
+EWKBReader::rings(polygon_t &polygon)
+{
+    uint32_t size = count(4);
+    polygon.clear();
+    if (size == 0) {
+        return;
+    }
+    points(polygon.outer());
+    polygon.inners().resize(size - 1);
+    for (auto &inner : polygon.inners()) {
+        points(inner);
+    }
+}
+
+bool
+EWKBReader::read(std::string_view hex, point_t &point)
+{
+    start(hex);
+    header(wkbPoint);
+    point = this->point();
+    return done();
+}
+
+bool
+EWKBReader::read(std::string_view hex, linestring_t &linestring)
+{
+    start(hex);
+    header(wkbLineString);
+    points(linestring);
+    return done();
+}
+
+bool
+EWKBReader::read(std::string_view hex, polygon_t &polygon)
+{
+    start(hex);
+    header(wkbPolygon);
+    rings(polygon);
+    return done();
+}
+
+bool
+EWKBReader::read(std::string_view hex, multilinestring_t &multilinestring)
+{
+    start(hex);
+    header(wkbMultiLineString);
+    multilinestring.resize(count(9));
+    for (auto &linestring : multilinestring) {
+        header(wkbLineString);
+        points(linestring);
+    }
+    return done();
+}
+
+bool
+EWKBReader::read(std::string_view hex, multipolygon_t &multipolygon)
+{
+    start(hex);
+    header(wkbMultiPolygon);
+    multipolygon.resize(count(9));
+    for (auto &polygon : multipolygon) {
+        header(wkbPolygon);
+        rings(polygon);
+    }
+    return done();
+}
+
+} // namespace wkb
+
+// local Variables:
+// mode: C++
+// indent-tabs-mode: nil
+// End:
@@ -0,0 +1,113 @@
+//
+// Copyright (c) 2025 Emilio Mariscal
+//
+// This file is part of Underpass.
+//
+//     Underpass is free software: you can redistribute it and/or modify
+//     it under the terms of the GNU General Public License as published by
+//     the Free Software Foundation, either version 3 of the License, or
+//     (at your option) any later version.
+//
+//     Underpass is distributed in the hope that it will be useful,
+//     but WITHOUT ANY WARRANTY; without even the implied warranty of
+//     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//     GNU General Public License for more details.
+//
+//     You should have received a copy of the GNU General Public License
+//     along with Underpass.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#ifndef __WKB_HH__
+#define __WKB_HH__
+
+/// \file wkb.hh
+/// \brief Well Known Binary encoding of geometries
+///
+/// Geometries are sent to and read from PostGIS as hex encoded EWKB,
+/// which is what PostGIS itself uses as the text representation of a
+/// geometry. The coordinates are copied as they are in memory, so there
+/// is no float to text conversion, and nobody has to parse WKT.
+
+// This is generated by autoconf
+#ifdef HAVE_CONFIG_H
+#include "unconfig.h"
+#endif
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+#include "osm/osmobjects.hh"
+
+/// \namespace wkb
+namespace wkb {
+
+/// \class EWKBWriter
+/// \brief Writes geometries as hex encoded little endian EWKB
+class EWKBWriter {
+  public:
+    EWKBWriter(uint32_t srid = 4326) : srid(srid) {};
+
+    /// Return the hex EWKB of a geometry
+    std::string hex(const point_t &point);
+    std::string hex(const linestring_t &linestring);
+    std::string hex(const polygon_t &polygon);
+    std::string hex(const multilinestring_t &multilinestring);
+    std::string hex(const multipolygon_t &multipolygon);
+
+    /// Return a geometry as an SQL literal, ready to be used in a query
+    template <typename T>
+    std::string literal(const T &geometry) {
+        return "'" + hex(geometry) + "'::geometry";
+    };
+
+  private:
+    uint32_t srid;
+    std::string data;
+
+    void header(uint32_t type, bool withSrid);
+    void uint32(uint32_t value);
+    void point(const point_t &point);
+    template <typename T>
+    void points(const T &range);
+    void rings(const polygon_t &polygon);
+};
+
+/// \class EWKBReader
+/// \brief Reads hex encoded WKB or EWKB in either byte order
+class EWKBReader {
+  public:
+    /// Read a geometry, returns false if the data isn't valid or
+    /// is another type of geometry
+    bool read(std::string_view hex, point_t &point);
+    bool read(std::string_view hex, linestring_t &linestring);
+    bool read(std::string_view hex, polygon_t &polygon);
+    bool read(std::string_view hex, multilinestring_t &multilinestring);
+    bool read(std::string_view hex, multipolygon_t &multipolygon);
+
+  private:
+    std::string_view data;
+    std::size_t pos = 0;
+    bool littleEndian = true;
+    bool valid = true;
+
+    void start(std::string_view hex);
+    bool done(void) const { return valid && pos == data.size(); };
+    uint64_t value(int bytes);
+    uint32_t uint32(void) { return value(4); };
+    void header(uint32_t type);
+    point_t point(void);
+    uint32_t count(std::size_t minBytes);
+    template <typename T>
+    void points(T &range);
+    void rings(polygon_t &polygon);
+};
+
+} // namespace wkb
+
+#endif  // EOF __WKB_HH__
+
+// local Variables:
+// mode: C++
+// indent-tabs-mode: nil
+// End:
@@ -125,6 +125,39 @@ getClosest(std::shared_ptr<std::vector<ReplicationTask>> tasks, ptime now) {
     return std::make_shared<ReplicationTask>(closest);
 }
 
+// Keep the newest of two timestamps
+static void
+keepNewest(ptime &newest, const ptime &timestamp) {
+    if (timestamp != not_a_date_time && (newest == not_a_date_time || timestamp > newest)) {
+        newest = timestamp;
+    }
+}
+
+// The node locations index can only be used if it has seen every change
+// written to the database, otherwise it may have old locations of nodes
+// modified while the replicator ran without it. A new index is adopted,
+// as it only gets the locations of the changes applied from now on.
+static bool
+checkNodeLocations(osmobjects::NodeLocations &nodelocations, QueryRaw &queryraw) {
+    auto database = queryraw.getDatabaseId();
+    if (nodelocations.timestamp() == 0) {
+        nodelocations.setDatabase(database);
+        nodelocations.sync();
+        return true;
+    }
+    if (nodelocations.database() != database) {
+        log_error("The node locations index belongs to another database (%1%)", nodelocations.database());
+        return false;
+    }
+    auto newest = queryraw.getNewestTimestamp();
+    if (newest != not_a_date_time && to_time_t(newest) > nodelocations.timestamp()) {
+        log_error("The node locations index is behind the database (%1% < %2%)",
+                  from_time_t(nodelocations.timestamp()), newest);
+        return false;
+    }
+    return true;
+}
+
 // Starting with this URL, download the file, incrementing
 void
 startMonitorChangesets(std::shared_ptr<replication::RemoteURL> &remote,
@@ -246,8 +279,13 @@ startMonitorChanges(std::shared_ptr<replication::RemoteURL> &remote,
 #ifdef MEMORY_DEBUG
     size_t sz, active1, active2;
 #endif    // JEMALLOC memory debugging
+    int cores = config.concurrency;
+    int concurrentTasks = cores*2;
+
+    // All the tasks share the database, each lookup leases a connection
+    // from the pool
     auto db = std::make_shared<Pq>();
-    if (!db->connect(config.underpass_db_url)) {
+    if (!db->connect(config.underpass_db_url, config.db_pool_size ? config.db_pool_size : concurrentTasks)) {
         log_error("Could not connect to Underpass DB, aborting monitoring thread!");
         return;
     } else {
@@ -255,7 +293,31 @@ startMonitorChanges(std::shared_ptr<replication::RemoteURL> &remote,
     }
     auto queryraw = std::make_shared<QueryRaw>(db);
 
-    int cores = config.concurrency;
+    // Databases created by older versions don't have all the tables
+    if (!queryraw->migrate()) {
+        log_error("Could not update the tables of the Underpass DB, aborting monitoring thread!");
+        return;
+    }
+
+    // The changes are written in the background, on a connection of their own
+    auto writerdb = std::make_shared<Pq>();
+    if (!writerdb->connect(config.underpass_db_url)) {
+        log_error("Could not connect to Underpass DB, aborting monitoring thread!");
+        return;
+    }
+    auto writer = std::make_shared<RawWriter>(writerdb);
+
+    // Local index of node locations
+    std::shared_ptr<osmobjects::NodeLocations> nodelocations;
+    if (!config.node_locations.empty()) {
+        nodelocations = std::make_shared<osmobjects::NodeLocations>();
+        if (!nodelocations->open(config.node_locations)) {
+            nodelocations.reset();
+        } else if (!checkNodeLocations(*nodelocations, *queryraw)) {
+            log_error("Remove %1% or import the data again, aborting monitoring thread!", config.node_locations);
+            return;
+        }
+    }
 
     // Support multiple OSM planet servers
     std::vector<std::shared_ptr<replication::Planet>> planets;
@@ -281,7 +343,9 @@ startMonitorChanges(std::shared_ptr<replication::RemoteURL> &remote,
     bool caughtUpWithNow = false;
     bool monitoring = true;
     auto underpassConfig = std::make_shared<UnderpassConfig>(config);
-    int concurrentTasks = cores*2;
+    // How often the writer counters are reported
+    const auto statsInterval = std::chrono::minutes{10};
+    auto lastStats = std::chrono::steady_clock::now();
 
     while (monitoring) {
         auto tasks = std::make_shared<std::vector<ReplicationTask>>(concurrentTasks);
@@ -305,7 +369,12 @@ startMonitorChanges(std::shared_ptr<replication::RemoteURL> &remote,
                 std::ref(tasks),
                 std::ref(queryraw),
                 underpassConfig,
-                concurrentTasks - i
+                concurrentTasks - i,
+                nodelocations,
+                // Files are processed in parallel while catching up, then
+                // one at a time using all the cores
+                static_cast<unsigned int>(std::max(1, cores / concurrentTasks)),
+                writer
             };
 
             auto task = boost::bind(threadOsmChange, osmChangeTask);
@@ -314,7 +383,43 @@ startMonitorChanges(std::shared_ptr<replication::RemoteURL> &remote,
             boost::asio::post(pool, task);
         } while (--i);
         pool.join();
-        db->query(allTasksQueries(tasks));
+        // Queue the changes of the files, in order
+        for (auto& task : *tasks) {
+            std::string queries;
+            for (const auto& query : task.query) {
+                queries.append(query);
+            }
+            task.query.clear();
+            // The node locations index is updated once the changes of the
+            // file are committed, so it never gets ahead of the database
+            std::function<void(void)> committed;
+            if (nodelocations) {
+                committed = [nodelocations, locations = std::move(task.locations), newest = task.newest] {
+                    for (const auto& location : locations) {
+                        if (location.removed) {
+                            nodelocations->remove(location.id);
+                        } else {
+                            nodelocations->set(location.id, location.lon, location.lat);
+                        }
+                    }
+                    if (newest != not_a_date_time) {
+                        nodelocations->setTimestamp(to_time_t(newest));
+                    }
+                    nodelocations->sync();
+                };
+            }
+            task.locations.clear();
+            writer->push(task.url, std::move(task.batch), std::move(queries), std::move(committed));
+            task.batch.clear();
+        }
+
+        if (std::chrono::steady_clock::now() - lastStats >= statsInterval) {
+            auto stats = writer->stats();
+            log_info("Committed %1% files in %2% transactions, %3% failed, %4% queued, latency %5%s average, %6%s max",
+                     stats.files, stats.commits, stats.failed, stats.queued,
+                     stats.commits ? stats.totalLatency / stats.commits : 0, stats.maxLatency);
+            lastStats = std::chrono::steady_clock::now();
+        }
 
         ptime now  = boost::posix_time::second_clock::universal_time();
         last_task = getClosest(tasks, now);
@@ -393,6 +498,7 @@ threadOsmChange(OsmChangeTask osmChangeTask)
     auto queryraw = osmChangeTask.queryraw;
     auto config = osmChangeTask.config;
     auto taskIndex = osmChangeTask.taskIndex;
+    auto nodelocations = osmChangeTask.nodelocations;
 
     auto osmchanges = std::make_shared<osmchange::OsmChangeFile>();
     log_debug("Processing OsmChange: %1%", remote->filespec);
@@ -434,11 +540,42 @@ threadOsmChange(OsmChangeTask osmChangeTask)
         }
     }
 
+    // The geometries are built with what is in the database, so the changes
+    // of the previous files must be there
+    if (osmChangeTask.writer) {
+        osmChangeTask.writer->flush();
+    }
+
     // Build features geometries
-    GeoBuilder geobuilder(poly, queryraw);
+    GeoBuilder geobuilder(poly, queryraw, nodelocations, osmChangeTask.concurrency);
     geobuilder.buildGeometries(osmchanges);
     osmchanges->areaFilter(poly);
 
+    // Keep the new node locations, all of them, as ways inside the priority
+    // area may reference nodes outside of it
+    if (nodelocations) {
+        for (const auto& change : osmchanges->changes) {
+            for (const auto& node : change->nodes) {
+                task.locations.push_back({
+                    node->id,
+                    NodeStore::toFixed(node->point.get<0>()),
+                    NodeStore::toFixed(node->point.get<1>()),
+                    node->action == osmobjects::remove
+                });
+            }
+            // The index has seen every object up to the newest one
+            for (const auto& node : change->nodes) {
+                keepNewest(task.newest, node->timestamp);
+            }
+            for (const auto& way : change->ways) {
+                keepNewest(task.newest, way->timestamp);
+            }
+            for (const auto& relation : change->relations) {
+                keepNewest(task.newest, relation->timestamp);
+            }
+        }
+    }
+
     // Raw data
     for (const auto& change : osmchanges->changes) {
         // Nodes
@@ -447,6 +584,10 @@ threadOsmChange(OsmChangeTask osmChangeTask)
                 continue;
             }
             //  Update nodes, ignore new ones outside priority area
+            if (!config->nocopy) {
+                task.batch.add(*node);
+                continue;
+            }
             auto queries = queryraw->applyChange(*node);
             for (const auto& query : *queries) {
                 task.query.push_back(query);
@@ -461,6 +602,10 @@ threadOsmChange(OsmChangeTask osmChangeTask)
             }
 
             //  Update ways, ignore new ones outside priority area
+            if (!config->nocopy) {
+                task.batch.add(*way);
+                continue;
+            }
             auto queries = queryraw->applyChange(*way);
             for (const auto& query : *queries) {
                 task.query.push_back(query);
@@ -473,6 +618,10 @@ threadOsmChange(OsmChangeTask osmChangeTask)
                 continue;
             }
             //  Update relations, ignore new ones outside priority area
+            if (!config->nocopy) {
+                task.batch.add(*relation);
+                continue;
+            }
             auto queries = queryraw->applyChange(*relation);
             for (const auto& query : *queries) {
                 task.query.push_back(query);
@@ -70,6 +70,9 @@ using tcp = net::ip::tcp;
 #include "replicator/replication.hh"
 #include "underpassconfig.hh"
 #include "raw/queryraw.hh"
+#include "raw/rawbatch.hh"
+#include "raw/rawwriter.hh"
+#include "osm/nodelocations.hh"
 #include <ogr_geometry.h>
 
 using namespace queryraw;
@@ -83,6 +86,15 @@ class RemoteURL;
 /// \namespace replicatorthreads
 namespace replicatorthreads {
 
+/// \struct NodeLocationChange
+/// \brief A change of a node location, for the node locations index
+struct NodeLocationChange {
+    long id;
+    int32_t lon;
+    int32_t lat;
+    bool removed;
+};
+
 /// \struct ReplicationTask
 /// \brief Represents a replication task
 struct ReplicationTask {
@@ -90,6 +102,9 @@ struct ReplicationTask {
     ptime timestamp = not_a_date_time;
     replication::reqfile_t status = replication::reqfile_t::none;
     std::vector<std::string> query;
+    queryraw::RawBatch batch; ///< Changes written with COPY, instead of the queries
+    std::vector<NodeLocationChange> locations; ///< Node locations changed, in file order
+    ptime newest = not_a_date_time; ///< The newest timestamp of the objects in the file
 };
 
 /// This monitors the planet server for new changesets files.
@@ -127,6 +142,11 @@ struct OsmChangeTask {
         std::shared_ptr<QueryRaw> queryraw;
         std::shared_ptr<UnderpassConfig> config;
         const int taskIndex;
+        std::shared_ptr<osmobjects::NodeLocations> nodelocations;
+        /// Threads for building the geometries of the file
+        unsigned int concurrency;
+        /// Writer of the changes of the previous files
+        std::shared_ptr<RawWriter> writer;
 };
 
 /// Updates the tables from a changeset file
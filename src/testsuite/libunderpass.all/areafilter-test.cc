@@ -36,7 +36,7 @@ void
 fillNodeCache(std::shared_ptr<osmchange::OsmChangeFile> &osmchange, geobuilder::GeoBuilder &geobuilder) {
     for (const auto& change : osmchange->changes) {
         for (const auto& node : change->nodes) {
-            geobuilder.nodecache.insert(std::make_pair(node->id, node));
+            geobuilder.nodecache.insert(*node);
         }
     }
 }
@@ -0,0 +1,293 @@
+//
+// Copyright (c) 2025 Emilio Mariscal
+//
+// This file is part of Underpass.
+//
+//     Underpass is free software: you can redistribute it and/or modify
+//     it under the terms of the GNU General Public License as published by
+//     the Free Software Foundation, either version 3 of the License, or
+//     (at your option) any later version.
+//
+//     Underpass is distributed in the hope that it will be useful,
+//     but WITHOUT ANY WARRANTY; without even the implied warranty of
+//     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//     GNU General Public License for more details.
+//
+//     You should have received a copy of the GNU General Public License
+//     along with Underpass.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+// Test and benchmark for GeoBuilder::buildGeometries() on synthetic change
+// files of increasing size. The database is replaced by a QueryRaw that
+// builds the objects on the fly, so only the geometry building is measured.
+// The testsuite runs it with small files, to benchmark it pass the number
+// of nodes of the base size, like geobuilder-test 20000.
+
+#include <dejagnu.h>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <string>
+#include "utils/log.hh"
+#include "osm/osmobjects.hh"
+#include "osm/osmchange.hh"
+#include "raw/queryraw.hh"
+#include "raw/geobuilder.hh"
+
+using namespace logger;
+using namespace queryraw;
+
+TestState runtest;
+
+// Ids of the objects that only exist in the "database"
+static const long dbOffset = 1000000000;
+
+class BenchQueryRaw : public QueryRaw {
+  public:
+    BenchQueryRaw(void) : QueryRaw(std::make_shared<Pq>()) {};
+
+    // The same lookups the single query of QueryRaw::getContext() does
+    Context getContext(const ContextIds &ids) const {
+        Context context;
+        IdSet skipWays, skipRelations, modified, members, located;
+        for (const auto id : ids.skipWays) skipWays.insert(id);
+        for (const auto id : ids.skipRelations) skipRelations.insert(id);
+        for (const auto id : ids.modifiedWays) modified.insert(id);
+        for (const auto &way : waysByNodes(ids.modifiedNodes)) {
+            if (!skipWays.count(way->id)) {
+                context.ways.push_back(way);
+                modified.insert(way->id);
+                if (ids.refNodes) {
+                    for (const auto ref : way->refs) located.insert(ref);
+                }
+            }
+        }
+        for (const auto id : modified) members.insert(id);
+        for (const auto id : ids.memberWays) members.insert(id);
+        for (const auto &relation : relationsByWays(modified.ids())) {
+            if (!skipRelations.count(relation->id)) {
+                context.relations.push_back(relation);
+                for (const auto &member : relation->members) {
+                    if (member.type == osmobjects::way) members.insert(member.ref);
+                }
+            }
+        }
+        context.geometries = geometries(members.ids());
+        for (const auto id : ids.nodes) located.insert(id);
+        context.nodes = locations(located.ids());
+        return context;
+    };
+
+  private:
+    // Every modified node is referenced by a way in the DB, which also
+    // references a node that is only in the DB
+    static std::vector<std::shared_ptr<OsmWay>> waysByNodes(const std::vector<long> &nodeIds) {
+        std::vector<std::shared_ptr<OsmWay>> ways;
+        for (const auto id : nodeIds) {
+            auto way = std::make_shared<OsmWay>();
+            way->id = dbOffset + id;
+            way->refs = {id, dbOffset + id};
+            ways.push_back(way);
+        }
+        return ways;
+    };
+
+    static std::vector<std::shared_ptr<OsmNode>> locations(const std::vector<long> &nodeIds) {
+        std::vector<std::shared_ptr<OsmNode>> nodes;
+        for (const auto id : nodeIds) {
+            auto node = std::make_shared<OsmNode>((id % 1000) * 0.001, (id / 1000) * 0.001);
+            node->id = id;
+            nodes.push_back(node);
+        }
+        return nodes;
+    };
+
+    static std::vector<std::shared_ptr<OsmWay>> geometries(const std::vector<long> &wayIds) {
+        std::vector<std::shared_ptr<OsmWay>> ways;
+        for (const auto id : wayIds) {
+            auto way = std::make_shared<OsmWay>();
+            way->id = id;
+            way->refs = {id, id + 1};
+            way->stored = waytable_t::line;
+            ways.push_back(way);
+        }
+        return ways;
+    };
+
+    // One relation for every 10 modified ways
+    static std::vector<std::shared_ptr<OsmRelation>> relationsByWays(const std::vector<long> &wayIds) {
+        std::vector<std::shared_ptr<OsmRelation>> relations;
+        for (std::size_t i = 0; i < wayIds.size(); i += 10) {
+            auto relation = std::make_shared<OsmRelation>();
+            relation->id = dbOffset + i;
+            for (std::size_t j = i; j < std::min(i + 10, wayIds.size()); ++j) {
+                relation->addMember(wayIds[j], osmobjects::way, "");
+            }
+            relations.push_back(relation);
+        }
+        return relations;
+    };
+};
+
+// A change file modifying n nodes and n / 2 ways
+std::shared_ptr<OsmChangeFile>
+makeChanges(long n)
+{
+    auto osmchanges = std::make_shared<OsmChangeFile>();
+    auto change = std::make_shared<OsmChange>(osmobjects::modify);
+    for (long id = 1; id <= n; ++id) {
+        auto node = change->newNode();
+        node->id = id;
+        node->action = osmobjects::modify;
+        node->setPoint((id % 1000) * 0.001, (id / 1000) * 0.001);
+    }
+    for (long id = 1; id <= n / 2; ++id) {
+        auto way = change->newWay();
+        way->id = id;
+        way->action = osmobjects::modify;
+        way->refs = {2 * id - 1, 2 * id, 2 * id + 1};
+    }
+    osmchanges->changes.push_back(change);
+    return osmchanges;
+}
+
+double
+bench(long n, unsigned int concurrency = 1,
+      std::shared_ptr<OsmChangeFile> osmchanges = nullptr)
+{
+    multipolygon_t poly;
+    std::shared_ptr<QueryRaw> queryraw = std::make_shared<BenchQueryRaw>();
+    if (!osmchanges) {
+        osmchanges = makeChanges(n);
+    }
+    geobuilder::GeoBuilder geobuilder(poly, queryraw, nullptr, concurrency);
+    auto start = std::chrono::steady_clock::now();
+    geobuilder.buildGeometries(osmchanges);
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    std::cout << "buildGeometries: " << n << " nodes, " << n / 2 << " ways, "
+              << concurrency << " threads: " << elapsed.count() << " seconds" << std::endl;
+    return elapsed.count();
+}
+
+// A multipolygon Relation with a single ring made of n Ways, with the
+// members not sorted, like a country boundary
+double
+benchRelation(long n)
+{
+    multipolygon_t poly;
+    std::shared_ptr<QueryRaw> queryraw = std::make_shared<BenchQueryRaw>();
+    geobuilder::GeoBuilder geobuilder(poly, queryraw);
+    OsmRelation relation;
+    relation.addTag("type", "multipolygon");
+    for (long i = 0; i < n; ++i) {
+        auto way = std::make_shared<OsmWay>();
+        way->id = i;
+        double angle = 2 * M_PI * i / n;
+        double next = 2 * M_PI * (i + 1) / n;
+        way->linestring = {point_t(std::cos(angle), std::sin(angle)),
+                           point_t(std::cos(angle + (next - angle) / 2), std::sin(angle + (next - angle) / 2)),
+                           point_t(std::cos(next), std::sin(next))};
+        if (i % 2) {
+            boost::geometry::reverse(way->linestring);
+        }
+        geobuilder.waycache.insert(i, way);
+    }
+    // 7919 is prime, so this visits every Way once
+    for (long i = 0; i < n; ++i) {
+        relation.addMember(i * 7919 % n, osmobjects::way, "outer");
+    }
+    auto start = std::chrono::steady_clock::now();
+    geobuilder.buildRelationGeometry(relation);
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    std::cout << "buildRelationGeometry: " << n << " members: "
+              << elapsed.count() << " seconds" << std::endl;
+    if (relation.multipolygon.size() != 1 ||
+        relation.multipolygon[0].outer().size() != static_cast<std::size_t>(2 * n + 1)) {
+        return -1;
+    }
+    return elapsed.count();
+}
+
+int
+main(int argc, char *argv[])
+{
+    logger::LogFile &dbglogfile = logger::LogFile::getDefaultInstance();
+    dbglogfile.setWriteDisk(true);
+    dbglogfile.setLogFilename("geobuilder-test.log");
+    dbglogfile.setVerbosity(0);
+
+    // The timings of small files are mostly noise, so the scaling is
+    // only checked when benchmarking
+    const bool benchmark = argc > 1;
+    const long base = benchmark ? std::stol(argv[1]) : 2000;
+    bench(base / 4);
+    double small = bench(base);
+    bench(base * 2);
+    double large = bench(base * 8);
+
+    // Linear scaling means 8 times the time for 8 times the data, a
+    // quadratic algorithm would take 64 times. Leave room for noise.
+    if (benchmark) {
+        if (large / small < 24) {
+            runtest.pass("GeoBuilder::buildGeometries() scales linearly");
+        } else {
+            runtest.fail("GeoBuilder::buildGeometries() scales linearly");
+            return 1;
+        }
+    }
+
+    // The geometries built in parallel must be the same
+    auto serial = makeChanges(base * 8);
+    auto parallel = makeChanges(base * 8);
+    bench(base * 8, 1, serial);
+    bench(base * 8, 4, parallel);
+    bool same = serial->changes.size() == parallel->changes.size();
+    for (auto a = serial->changes.begin(), b = parallel->changes.begin();
+         same && a != serial->changes.end(); ++a, ++b) {
+        for (std::size_t i = 0; same && i < (*a)->ways.size(); ++i) {
+            same = (*a)->ways[i]->id == (*b)->ways[i]->id &&
+                boost::geometry::equals((*a)->ways[i]->linestring, (*b)->ways[i]->linestring);
+        }
+    }
+    if (same) {
+        runtest.pass("GeoBuilder::buildGeometries() in parallel");
+    } else {
+        runtest.fail("GeoBuilder::buildGeometries() in parallel");
+        return 1;
+    }
+
+    // The modified ways know their table from the geometries in the DB
+    bool stored = true;
+    for (const auto &way : serial->changes.front()->ways) {
+        stored = stored && way->stored == waytable_t::line && !way->mayChangeTable();
+    }
+    if (stored) {
+        runtest.pass("GeoBuilder::buildGeometries() finds the stored tables");
+    } else {
+        runtest.fail("GeoBuilder::buildGeometries() finds the stored tables");
+        return 1;
+    }
+
+    benchRelation(base / 4);
+    small = benchRelation(base);
+    large = benchRelation(base * 8);
+    if (small >= 0 && large >= 0) {
+        runtest.pass("GeoBuilder::buildRelationGeometry() joins the ring");
+    } else {
+        runtest.fail("GeoBuilder::buildRelationGeometry() joins the ring");
+        return 1;
+    }
+    if (benchmark) {
+        if (large / small < 24) {
+            runtest.pass("GeoBuilder::buildRelationGeometry() scales linearly");
+        } else {
+            runtest.fail("GeoBuilder::buildRelationGeometry() scales linearly");
+            return 1;
+        }
+    }
+}
+
+// local Variables:
+// mode: C++
+// indent-tabs-mode: nil
+// End:
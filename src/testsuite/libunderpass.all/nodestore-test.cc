@@ -0,0 +1,183 @@
+//
+// Copyright (c) 2025 Emilio Mariscal
+//
+// This file is part of Underpass.
+//
+//     Underpass is free software: you can redistribute it and/or modify
+//     it under the terms of the GNU General Public License as published by
+//     the Free Software Foundation, either version 3 of the License, or
+//     (at your option) any later version.
+//
+//     Underpass is distributed in the hope that it will be useful,
+//     but WITHOUT ANY WARRANTY; without even the implied warranty of
+//     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//     GNU General Public License for more details.
+//
+//     You should have received a copy of the GNU General Public License
+//     along with Underpass.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#include <dejagnu.h>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include "osm/osmobjects.hh"
+#include "osm/nodestore.hh"
+#include "osm/nodelocations.hh"
+#include "osm/idmap.hh"
+
+using namespace osmobjects;
+
+TestState runtest;
+
+int
+main(int argc, char *argv[])
+{
+    NodeStore store;
+    OsmNode node;
+    node.id = 1;
+    node.setPoint(-34.6037232, -58.3815931);
+    store.insert(node);
+    store.insert(2, -58.4, -34.7);
+    store.insert(3, 2.3522219, 48.856614);
+
+    if (store.size() == 3 && !store.insert(2, 0, 0) && store.size() == 3) {
+        runtest.pass("NodeStore::insert() keeps the first node");
+    } else {
+        runtest.fail("NodeStore::insert() keeps the first node");
+        return 1;
+    }
+
+    // Coordinates with 7 decimals must come back unchanged
+    auto point = store.at(1);
+    if (point.get<0>() == -58.3815931 && point.get<1>() == -34.6037232) {
+        runtest.pass("NodeStore::at() fixed point coordinates");
+    } else {
+        runtest.fail("NodeStore::at() fixed point coordinates");
+        return 1;
+    }
+
+    if (store.count(3) && !store.count(4)) {
+        runtest.pass("NodeStore::count()");
+    } else {
+        runtest.fail("NodeStore::count()");
+        return 1;
+    }
+
+    multipolygon_t poly;
+    boost::geometry::read_wkt("MULTIPOLYGON(((-59 -35,-58 -35,-58 -34,-59 -34,-59 -35)))", poly);
+    std::vector<uint8_t> inside;
+    store.within(poly, inside);
+    if (inside.size() == 3 && inside[0] && inside[1] && !inside[2]) {
+        runtest.pass("NodeStore::within()");
+    } else {
+        runtest.fail("NodeStore::within()");
+        return 1;
+    }
+
+    // Two versions of the same node, each one keeps its own position
+    NodeStore versions;
+    versions.append(5, -58.5, -34.5);
+    versions.append(5, 2.3522219, 48.856614);
+    versions.within(poly, inside);
+    if (versions.size() == 2 && inside.size() == 2 && inside[0] && !inside[1] &&
+        versions.find(5) == 0) {
+        runtest.pass("NodeStore::append()");
+    } else {
+        runtest.fail("NodeStore::append()");
+        return 1;
+    }
+
+    // A small index, so the test doesn't need a big sparse file
+    const long maxNodeId = 100000;
+    std::string filespec = std::filesystem::temp_directory_path() / "nodelocations-test.idx";
+    std::filesystem::remove(filespec);
+    {
+        NodeLocations locations(maxNodeId);
+        if (!locations.open(filespec) || locations.timestamp() != 0 || !locations.database().empty()) {
+            runtest.fail("NodeLocations::open()");
+            return 1;
+        }
+        locations.set(99999, store.lons[0], store.lats[0]);
+        locations.set(maxNodeId + 1, store.lons[0], store.lats[0]);
+        locations.set(2, 0, 0);
+        locations.set(3, store.lons[2], store.lats[2]);
+        locations.remove(3);
+        locations.setDatabase("underpass_test");
+        locations.setTimestamp(1700000000);
+        locations.setTimestamp(1600000000);
+        // The timestamp only reaches the file after the locations
+        NodeLocations reader(maxNodeId);
+        if (!reader.open(filespec) || reader.timestamp() != 0 ||
+            locations.timestamp() != 1700000000) {
+            runtest.fail("NodeLocations::sync() writes the timestamp last");
+            return 1;
+        }
+        locations.sync();
+        if (reader.timestamp() == 1700000000) {
+            runtest.pass("NodeLocations::sync() writes the timestamp last");
+        } else {
+            runtest.fail("NodeLocations::sync() writes the timestamp last");
+            return 1;
+        }
+    }
+    NodeLocations locations(maxNodeId);
+    locations.open(filespec);
+    int32_t lon, lat;
+    if (locations.get(99999, lon, lat) && lon == store.lons[0] && lat == store.lats[0] &&
+        locations.get(2, lon, lat) && lon == 0 && lat == 0 &&
+        !locations.get(3, lon, lat) && !locations.get(4, lon, lat) &&
+        !locations.get(maxNodeId + 1, lon, lat)) {
+        runtest.pass("NodeLocations::get()");
+    } else {
+        runtest.fail("NodeLocations::get()");
+        return 1;
+    }
+    if (locations.timestamp() == 1700000000 && locations.database() == "underpass_test") {
+        runtest.pass("NodeLocations keeps its state");
+    } else {
+        runtest.fail("NodeLocations keeps its state");
+        return 1;
+    }
+    locations.close();
+
+    // The file can't be opened for another number of ids, and truncate
+    // discards the state and the locations
+    NodeLocations bigger(maxNodeId * 2);
+    NodeLocations truncated(maxNodeId);
+    if (!bigger.open(filespec) && truncated.open(filespec, true) &&
+        truncated.timestamp() == 0 && !truncated.get(99999, lon, lat)) {
+        runtest.pass("NodeLocations::open() checks the file");
+    } else {
+        runtest.fail("NodeLocations::open() checks the file");
+        return 1;
+    }
+    truncated.close();
+    std::filesystem::remove(filespec);
+
+    IdSet ids;
+    for (long id = 0; id < 1000; ++id) {
+        ids.insert(id % 100 * 4294967296);
+    }
+    if (ids.size() == 100 && ids.count(99 * 4294967296) && !ids.count(1) &&
+        ids.ids().front() == 0 && ids.ids().back() == 99 * 4294967296) {
+        runtest.pass("IdSet removes duplicates");
+    } else {
+        runtest.fail("IdSet removes duplicates");
+        return 1;
+    }
+
+    IdSet moved = std::move(ids);
+    ids.insert(7);
+    if (moved.size() == 100 && ids.size() == 1 && ids.count(7) && !ids.count(0)) {
+        runtest.pass("IdSet can be used after a move");
+    } else {
+        runtest.fail("IdSet can be used after a move");
+        return 1;
+    }
+}
+
+// local Variables:
+// mode: C++
+// indent-tabs-mode: nil
+// End:
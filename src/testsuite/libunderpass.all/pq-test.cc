@@ -18,6 +18,7 @@
 //
 
 #include "data/pq.hh"
+#include "data/utils.hh"
 #include "utils/log.hh"
 #include <dejagnu.h>
 #include <iostream>
@@ -102,6 +103,100 @@ main(int argc, char *argv[])
         runtest.fail("PQ::parseURL(user:pass@remote)");
         return 1;
     }
+
+    // Node ids above 2^53 can't be represented as a double
+    datautils::DataUtils utils(nullptr);
+    auto refs = utils.arrayStrToVector("{9007199254740993,-2,3}");
+    if (refs == std::pmr::vector<long>{9007199254740993, -2, 3} &&
+        utils.arrayStrToVector("{}").empty()) {
+        runtest.pass("DataUtils::arrayStrToVector()");
+    } else {
+        runtest.fail("DataUtils::arrayStrToVector()");
+        return 1;
+    }
+
+    // The JSON written with COPY isn't escaped for SQL, only for JSON
+    OsmNode node;
+    node.addTag("name", "O'Higgins \"El Libertador\"");
+    node.addTag("note", "a\\b\nc");
+    std::pmr::vector<OsmRelationMember> members = {{1, osmobjects::way, "outer"}, {2, osmobjects::node, "label\""}};
+    if (datautils::DataUtils::buildTagsJSON(node.tags) ==
+            "{\"name\":\"O'Higgins \\\"El Libertador\\\"\",\"note\":\"a\\\\b\\nc\"}" &&
+        datautils::DataUtils::buildMembersJSON(members) ==
+            "[{\"role\":\"outer\",\"type\":\"way\",\"ref\":1},{\"role\":\"label\\\"\",\"type\":\"node\",\"ref\":2}]" &&
+        datautils::DataUtils::buildTagsJSON(OsmNode().tags).empty()) {
+        runtest.pass("DataUtils::buildTagsJSON()");
+    } else {
+        runtest.fail("DataUtils::buildTagsJSON()");
+        return 1;
+    }
+
+    // In a query the single quotes are doubled too, and control
+    // characters are escaped
+    node.addTag("tab", std::string("x\ty\x01z\0", 7));
+    if (utils.buildTagsQuery(node.tags) ==
+            "'{\"name\":\"O''Higgins \\\"El Libertador\\\"\",\"note\":\"a\\\\b\\nc\",\"tab\":\"x\\ty\\u0001z\"}'::jsonb" &&
+        utils.buildMembersQuery(members) ==
+            "'[{\"role\":\"outer\",\"type\":\"way\",\"ref\":1},{\"role\":\"label\\\"\",\"type\":\"node\",\"ref\":2}]'::jsonb" &&
+        utils.buildTagsQuery(OsmNode().tags) == "null") {
+        runtest.pass("DataUtils::buildTagsQuery()");
+    } else {
+        runtest.fail("DataUtils::buildTagsQuery()");
+        return 1;
+    }
+
+    // The tags and members read back are the ones written, and the
+    // escapes jsonb may write are decoded
+    OsmNode parsed;
+    std::pmr::vector<OsmRelationMember> parsedMembers;
+    if (datautils::DataUtils::parseTagsJSON(datautils::DataUtils::buildTagsJSON(node.tags), parsed.tags) &&
+        parsed.tags.size() == 3 &&
+        parsed.getTagValue("name") == "O'Higgins \"El Libertador\"" &&
+        parsed.getTagValue("note") == "a\\b\nc" &&
+        datautils::DataUtils::parseTagsJSON("{\"a\": \"caf\\u00e9 \\ud83d\\ude00\", \"b\": 1}", parsed.tags) &&
+        parsed.getTagValue("a") == "caf\xc3\xa9 \xf0\x9f\x98\x80" &&
+        parsed.getTagValue("b") == "1" &&
+        !datautils::DataUtils::parseTagsJSON("{\"a\": \"b\"", parsed.tags) &&
+        datautils::DataUtils::parseMembersJSON(datautils::DataUtils::buildMembersJSON(members), parsedMembers) &&
+        datautils::DataUtils::parseMembersJSON("[{\"ref\": \"3\", \"role\": \"\", \"type\": \"r\"}]", parsedMembers) &&
+        parsedMembers.size() == 3 &&
+        parsedMembers[0].ref == 1 && parsedMembers[0].type == osmobjects::way && parsedMembers[0].role == "outer" &&
+        parsedMembers[1].ref == 2 && parsedMembers[1].type == osmobjects::node && parsedMembers[1].role == "label\"" &&
+        parsedMembers[2].ref == 3 && parsedMembers[2].type == osmobjects::relation) {
+        runtest.pass("DataUtils::parseTagsJSON()");
+    } else {
+        runtest.fail("DataUtils::parseTagsJSON()");
+        return 1;
+    }
+
+    // Invalid JSON adds nothing
+    TagList invalid;
+    std::pmr::vector<OsmRelationMember> invalidMembers;
+    if (!datautils::DataUtils::parseTagsJSON("{\"a\": \"b\", \"c\": ", invalid) && invalid.empty() &&
+        !datautils::DataUtils::parseTagsJSON("{\"a\": \"\\udc00\"}", invalid) && invalid.empty() &&
+        datautils::DataUtils::parseTagsJSON("{\"a\": \"b\"}", invalid) &&
+        !datautils::DataUtils::parseTagsJSON("{\"c\": \"d\", \"a\": 1", invalid) &&
+        invalid.size() == 1 && invalid.get("a") == "b" &&
+        datautils::DataUtils::parseMembersJSON("[{\"ref\": 1, \"role\": \"\", \"type\": \"w\"}]", invalidMembers) &&
+        !datautils::DataUtils::parseMembersJSON("[{\"ref\": 2, \"type\": \"n\"}, {\"ref\": x}]", invalidMembers) &&
+        invalidMembers.size() == 1 && invalidMembers[0].ref == 1) {
+        runtest.pass("DataUtils::parseTagsJSON(invalid)");
+    } else {
+        runtest.fail("DataUtils::parseTagsJSON(invalid)");
+        return 1;
+    }
+
+    // Escaping doesn't need a connection. Backslashes are plain characters
+    // with standard_conforming_strings, so they can't escape a quote
+    if (pq::Pq::escapedString("O'Brien \\o/") == "O''Brien \\o/" &&
+        pq::Pq::escapedString("a\\'; DROP TABLE nodes; --") == "a\\''; DROP TABLE nodes; --" &&
+        pq::Pq::escapedString("\\\\'") == "\\\\''" &&
+        pq::Pq::escapedString(std::string("a\0b", 3)) == "ab") {
+        runtest.pass("PQ::escapedString()");
+    } else {
+        runtest.fail("PQ::escapedString()");
+        return 1;
+    }
 }
 
 // local Variables:
@@ -0,0 +1,150 @@
+//
+// Copyright (c) 2025 Emilio Mariscal
+//
+// This file is part of Underpass.
+//
+//     Underpass is free software: you can redistribute it and/or modify
+//     it under the terms of the GNU General Public License as published by
+//     the Free Software Foundation, either version 3 of the License, or
+//     (at your option) any later version.
+//
+//     Underpass is distributed in the hope that it will be useful,
+//     but WITHOUT ANY WARRANTY; without even the implied warranty of
+//     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//     GNU General Public License for more details.
+//
+//     You should have received a copy of the GNU General Public License
+//     along with Underpass.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#include <dejagnu.h>
+#include <iostream>
+#include <string>
+#include <memory_resource>
+#include "osm/osmobjects.hh"
+#include "osm/tags.hh"
+
+using namespace osmobjects;
+
+TestState runtest;
+
+int
+main(int argc, char *argv[])
+{
+    OsmWay way;
+    way.addTag("building", "yes");
+    way.addTag("name", "Escuela 123");
+    way.addTag("building", "school");
+
+    if (way.tags.size() == 2 && way.getTagValue("building") == "school") {
+        runtest.pass("TagList::set() replaces existing values");
+    } else {
+        runtest.fail("TagList::set() replaces existing values");
+        return 1;
+    }
+
+    if (way.containsKey("name") && !way.containsKey("highway") &&
+        way.getTagValue("highway").empty()) {
+        runtest.pass("TagList::contains()");
+    } else {
+        runtest.fail("TagList::contains()");
+        return 1;
+    }
+
+    // Both objects share the same interned strings
+    OsmNode node;
+    node.addTag("building", "school");
+    if (node.getTagValue("building").data() == way.getTagValue("building").data()) {
+        runtest.pass("StringInterner shares strings between objects");
+    } else {
+        runtest.fail("StringInterner shares strings between objects");
+        return 1;
+    }
+
+    std::string keys;
+    for (const auto [key, value] : way.tags) {
+        keys += std::string(key) + "=" + std::string(value) + ";";
+    }
+    if (keys == "building=school;name=Escuela 123;") {
+        runtest.pass("TagList iteration keeps insertion order");
+    } else {
+        runtest.fail("TagList iteration keeps insertion order");
+        return 1;
+    }
+
+    OsmWay copy = way;
+    way.tags.erase("name");
+    if (copy.tags.size() == 2 && way.tags.size() == 1 && copy.getTagValue("name") == "Escuela 123") {
+        runtest.pass("TagList copy");
+    } else {
+        runtest.fail("TagList copy");
+        return 1;
+    }
+
+    // Names aren't interned, replacing and erasing them keeps the
+    // other local strings
+    OsmNode shop;
+    shop.addTag("name", "Panaderia");
+    shop.addTag("shop", "bakery");
+    shop.addTag("note", "Open on sundays");
+    shop.addTag("name", "Panaderia La Esquina");
+    shop.tags.erase("shop");
+    shop.addTag("addr:street", "Calle 8");
+    shop.tags.erase("name");
+    if (shop.tags.size() == 2 && shop.getTagValue("note") == "Open on sundays" &&
+        shop.getTagValue("addr:street") == "Calle 8" && !shop.containsKey("name")) {
+        runtest.pass("TagList local strings");
+    } else {
+        runtest.fail("TagList local strings");
+        return 1;
+    }
+
+    OsmRelation relation;
+    relation.addTag("type", "boundary");
+    if (relation.isMultiPolygon()) {
+        runtest.pass("OsmRelation::isMultiPolygon()");
+    } else {
+        runtest.fail("OsmRelation::isMultiPolygon()");
+        return 1;
+    }
+
+    // Objects built on an arena keep their tags, refs and members in
+    // it, the arena can't grow so anything else would throw
+    static char buffer[4096];
+    std::pmr::monotonic_buffer_resource arena(buffer, sizeof(buffer),
+                                              std::pmr::null_memory_resource());
+    auto inArena = [](const void *ptr) {
+        return ptr >= buffer && ptr < buffer + sizeof(buffer);
+    };
+    OsmWay street(&arena);
+    OsmRelation route(&arena);
+    for (long ref = 1; ref <= 10; ++ref) {
+        street.addRef(ref);
+        route.addMember(ref, osmobjects::way, "");
+    }
+    for (int i = 0; i < 6; ++i) {
+        street.addTag("name:" + std::to_string(i), "Avenida Siempre Viva " + std::to_string(i));
+    }
+    if (inArena(street.refs.data()) && inArena(route.members.data()) &&
+        inArena(&*street.getTagValue("name:5").begin()) && street.tags.size() == 6) {
+        runtest.pass("OsmObject on an arena");
+    } else {
+        runtest.fail("OsmObject on an arena");
+        return 1;
+    }
+
+    // Copies don't depend on the arena
+    OsmWay detached = street;
+    if (!inArena(detached.refs.data()) && !inArena(&*detached.getTagValue("name:5").begin()) &&
+        detached.refs == street.refs && detached.getTagValue("name:5") == "Avenida Siempre Viva 5") {
+        runtest.pass("OsmObject copy from an arena");
+    } else {
+        runtest.fail("OsmObject copy from an arena");
+        return 1;
+    }
+}
+
+// local Variables:
+// mode: C++
+// indent-tabs-mode: nil
+// End:
@@ -49,7 +49,7 @@ main(int argc, char* argv[])
 
     Underpass under("underpass");
 
-    if (under.sdb->is_open()) {
+    if (under.isOpen()) {
         runtest.pass("Underpass::connect");
     } else {
         runtest.fail("Underpass::connect");
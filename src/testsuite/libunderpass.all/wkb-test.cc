@@ -0,0 +1,127 @@
+//
+// Copyright (c) 2025 Emilio Mariscal
+//
+// This file is part of Underpass.
+//
+//     Underpass is free software: you can redistribute it and/or modify
+//     it under the terms of the GNU General Public License as published by
+//     the Free Software Foundation, either version 3 of the License, or
+//     (at your option) any later version.
+//
+//     Underpass is distributed in the hope that it will be useful,
+//     but WITHOUT ANY WARRANTY; without even the implied warranty of
+//     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//     GNU General Public License for more details.
+//
+//     You should have received a copy of the GNU General Public License
+//     along with Underpass.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#include <dejagnu.h>
+#include <iostream>
+#include <string>
+#include "osm/osmobjects.hh"
+#include "raw/wkb.hh"
+
+namespace bg = boost::geometry;
+
+TestState runtest;
+
+// Compare with the EWKB written by PostGIS, ST_AsHexEWKB() returns the
+// same strings for these geometries
+void
+check(const std::string &name, const std::string &result, const std::string &expected)
+{
+    if (result == expected) {
+        runtest.pass(name);
+    } else {
+        runtest.fail(name);
+        std::cout << result << std::endl;
+        exit(1);
+    }
+}
+
+int
+main(int argc, char *argv[])
+{
+    wkb::EWKBWriter writer;
+
+    check("EWKBWriter::hex(point_t)",
+        writer.hex(point_t(-58.3815931, -34.6037232)),
+        "0101000020E61000008C70EE0AD8304DC011EB43CD464D41C0");
+
+    linestring_t linestring;
+    bg::read_wkt("LINESTRING(0 0,1 1)", linestring);
+    check("EWKBWriter::hex(linestring_t)", writer.hex(linestring),
+        "0102000020E61000000200000000000000000000000000000000000000000000000000F03F000000000000F03F");
+
+    polygon_t polygon;
+    bg::read_wkt("POLYGON((0 0,0 1,1 1,0 0))", polygon);
+    check("EWKBWriter::hex(polygon_t)", writer.hex(polygon),
+        "0103000020E61000000100000004000000000000000000000000000000000000000000000000000000000000000000F03F"
+        "000000000000F03F000000000000F03F00000000000000000000000000000000");
+
+    multilinestring_t multilinestring;
+    bg::read_wkt("MULTILINESTRING((0 0,1 1),(1 1,2 2))", multilinestring);
+    check("EWKBWriter::hex(multilinestring_t)", writer.hex(multilinestring),
+        "0105000020E61000000200000001020000000200000000000000000000000000000000000000000000000000F03F"
+        "000000000000F03F010200000002000000000000000000F03F000000000000F03F00000000000000400000000000000040");
+
+    multipolygon_t multipolygon;
+    bg::read_wkt("MULTIPOLYGON(((0 0,0 1,1 1,0 0)))", multipolygon);
+    check("EWKBWriter::hex(multipolygon_t)", writer.hex(multipolygon),
+        "0106000020E61000000100000001030000000100000004000000000000000000000000000000000000000000000000000000"
+        "000000000000F03F000000000000F03F000000000000F03F00000000000000000000000000000000");
+
+    check("EWKBWriter::literal()", writer.literal(point_t(0, 0)),
+        "'0101000020E610000000000000000000000000000000000000'::geometry");
+
+    // What is written must be read back exactly
+    wkb::EWKBReader reader;
+    polygon_t donut;
+    bg::read_wkt("POLYGON((0 0,0 10,10 10,10 0,0 0),(2 2,2 3,3 3,2 2))", donut);
+    polygon_t polygonResult;
+    multilinestring_t multilinestringResult;
+    multipolygon_t multipolygonResult;
+    linestring_t linestringResult;
+    point_t pointResult;
+    multipolygon.push_back(donut);
+    if (reader.read(writer.hex(point_t(-58.3815931, -34.6037232)), pointResult) &&
+        bg::equals(pointResult, point_t(-58.3815931, -34.6037232)) &&
+        reader.read(writer.hex(donut), polygonResult) && bg::equals(donut, polygonResult) &&
+        polygonResult.inners().size() == 1 &&
+        reader.read(writer.hex(multilinestring), multilinestringResult) &&
+        bg::equals(multilinestring, multilinestringResult) &&
+        reader.read(writer.hex(multipolygon), multipolygonResult) &&
+        multipolygonResult.size() == 2 && bg::equals(multipolygon, multipolygonResult)) {
+        runtest.pass("EWKBReader::read()");
+    } else {
+        runtest.fail("EWKBReader::read()");
+        return 1;
+    }
+
+    // Big endian WKB without a SRID, as written by ST_AsBinary(geom, 'XDR')
+    if (reader.read("\\x000000000200000002000000000000000000000000000000003FF00000000000003FF0000000000000",
+                    linestringResult) && bg::equals(linestringResult, linestring)) {
+        runtest.pass("EWKBReader::read(big endian)");
+    } else {
+        runtest.fail("EWKBReader::read(big endian)");
+        return 1;
+    }
+
+    // Another type of geometry, truncated data and a count that doesn't
+    // fit in the data
+    if (!reader.read(writer.hex(linestring), polygonResult) &&
+        !reader.read(writer.hex(linestring).substr(0, 60), linestringResult) &&
+        !reader.read("0102000020E6100000FFFFFF7F", linestringResult)) {
+        runtest.pass("EWKBReader::read(invalid)");
+    } else {
+        runtest.fail("EWKBReader::read(invalid)");
+        return 1;
+    }
+}
+
+// local Variables:
+// mode: C++
+// indent-tabs-mode: nil
+// End:
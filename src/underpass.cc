@@ -110,16 +110,24 @@ main(int argc, char *argv[])
             ("oscnoboundary", "Disable boundary polygon for Changesets")
             ("datadir", opts::value<std::string>(), "Directory for remote and local cached files (with ending slash)")
             ("destdir_base", opts::value<std::string>(), "Base directory for local cached files (with ending slash)")
+            ("nodelocations", opts::value<std::string>(), "File for the node locations index, used to build geometries without querying the database")
             ("verbose,v", "Enable verbosity")
             ("logstdout,l", "Enable logging to stdout, default is log to underpass.log")
             ("changefile", opts::value<std::string>(), "Import change file")
             ("concurrency,c", opts::value<std::string>(), "Concurrency")
+            ("dbpool", opts::value<unsigned int>(), "Number of database connections (defaults to one for every concurrent task)")
             ("changesets", "Changesets only")
             ("osmchanges", "OsmChanges only")
             ("debug,d", "Enable debug messages for developers")
             ("norefs", "Disable refs (useful for non OSM data)")
+            ("nocopy", "Write changes with SQL statements instead of COPY")
             ("config", "Dump config")
             ("import,i", opts::value<std::string>(), "Initialize OSM database with OSM PBF datafile")
+            ("reindex", "Rebuild the database indexes, without locking the tables")
+            ("partitions", opts::value<unsigned int>(), "Split the raw tables in this number of osm_id ranges on import")
+            ("bulkload", "Import into UNLOGGED tables without constraints, and finalize them after the import")
+            ("locationindex", opts::value<std::string>(), "Index of node locations used on import: flex_mem, sparse_mem_array, dense_mmap_array, sparse_file_array or dense_file_array")
+            ("locationindexfile", opts::value<std::string>(), "File for the index of node locations used on import, required by the file based indexes. It must be empty or not exist")
             ("silent", "Silent");
         // clang-format on
 
@@ -135,6 +143,9 @@ main(int argc, char *argv[])
     if (vm.count("norefs")) {
         config.norefs = true;
     }
+    if (vm.count("nocopy")) {
+        config.nocopy = true;
+    }
 
     // Logging
     logger::LogFile &dbglogfile = logger::LogFile::getDefaultInstance();
@@ -162,6 +173,19 @@ main(int argc, char *argv[])
         config.destdir_base = vm["destdir_base"].as<std::string>();
     }
 
+    // Node locations index
+    if (vm.count("nodelocations")) {
+        config.node_locations = vm["nodelocations"].as<std::string>();
+    }
+
+    // Node locations index used on import
+    if (vm.count("locationindex")) {
+        config.location_index = vm["locationindex"].as<std::string>();
+    }
+    if (vm.count("locationindexfile")) {
+        config.location_index_file = vm["locationindexfile"].as<std::string>();
+    }
+
     // Concurrency
     if (vm.count("concurrency")) {
         const auto concurrency = vm["concurrency"].as<std::string>();
@@ -179,6 +203,17 @@ main(int argc, char *argv[])
         config.concurrency = std::thread::hardware_concurrency();
     }
 
+    // Database connections
+    if (vm.count("dbpool")) {
+        config.db_pool_size = vm["dbpool"].as<unsigned int>();
+    }
+    if (vm.count("partitions")) {
+        config.db_partitions = vm["partitions"].as<unsigned int>();
+    }
+    if (vm.count("bulkload")) {
+        config.bulkload = true;
+    }
+
     // Used to store timestamp information for running Underpass
     std::vector<std::string> timestamps;
     if (vm.count("timestamp")) {
@@ -202,28 +237,66 @@ main(int argc, char *argv[])
         exit(0);
     }
     
+    // Rebuild the indexes of a live database
+    if (vm.count("reindex")) {
+        auto boostrapper = bootstrap::Bootstrap();
+        if (!boostrapper.start(config)) {
+            return 1;
+        }
+        std::cout << "Rebuilding indexes ..." << std::endl;
+        return boostrapper.createDBIndexes(true) ? 0 : 1;
+    }
+
     // Bootstrapping
     if (vm.count("import")){
 
         auto boostrapper = bootstrap::Bootstrap();
-        boostrapper.start(config);
+        if (!boostrapper.start(config)) {
+            return 1;
+        }
 
         // Initialize DB (create tables, etc ...)
         std::cout << "Initializing DB ..." << std::endl;
-        boostrapper.initializeDB();
+        if (!boostrapper.initializeDB(config.db_partitions, config.bulkload)) {
+            log_error("Couldn't initialize the database, not importing");
+            return 1;
+        }
 
         config.import = vm["import"].as<std::string>();
+        bool imported = false;
         std::thread bootstrapThread;
-        bootstrapThread = std::thread(&bootstrap::Bootstrap::start, &boostrapper, std::ref(config));
+        bootstrapThread = std::thread([&boostrapper, &config, &imported] {
+            imported = boostrapper.start(config);
+        });
         log_info("Waiting...");
         if (bootstrapThread.joinable()) {
             bootstrapThread.join();
         }
 
+        // A partial import isn't finished, so it can be done again
+        if (!imported) {
+            log_error("Couldn't import %1%, not starting the replicator", config.import);
+            return 1;
+        }
+
         // For running the replicator process
         timestamps.push_back("latest");
         config.latest = true;
 
+        // The replicator can't write to the tables until they have
+        // their primary keys
+        if (config.bulkload) {
+            std::cout << "Finalizing tables ..." << std::endl;
+            if (!boostrapper.finalizeDB()) {
+                log_error("Couldn't finalize the tables, not starting the replicator");
+                return 1;
+            }
+        }
+
+        // Vacuum and analyze the imported data
+        std::cout << "Vacuuming tables ..." << std::endl;
+        boostrapper.vacuumDB();
+
         // Create DB indexes
         std::cout << "Creating indexes ..." << std::endl;
         boostrapper.createDBIndexes();
@@ -233,7 +306,9 @@ main(int argc, char *argv[])
     // Use latest timestamp in the DB as start time
     if (config.latest) {
         auto boostrapper = bootstrap::Bootstrap();
-        boostrapper.start(config);
+        if (!boostrapper.start(config)) {
+            return 1;
+        }
         config.start_time = boostrapper.getLatestTimestamp();
         std::cout << "Starting ..." << std::endl << std::endl;
     }
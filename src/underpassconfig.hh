@@ -125,6 +125,21 @@ struct UnderpassConfig {
             if (yaml.contains_key("destdir_base")) {
                 destdir_base = yamlConfig.get_value("destdir_base");
             }
+            if (yaml.contains_key("node_locations")) {
+                node_locations = yamlConfig.get_value("node_locations");
+            }
+            if (yaml.contains_key("location_index")) {
+                location_index = yamlConfig.get_value("location_index");
+            }
+            if (yaml.contains_key("location_index_file")) {
+                location_index_file = yamlConfig.get_value("location_index_file");
+            }
+            if (yaml.contains_key("db_pool_size")) {
+                db_pool_size = std::stoul(yamlConfig.get_value("db_pool_size"));
+            }
+            if (yaml.contains_key("db_partitions")) {
+                db_partitions = std::stoul(yamlConfig.get_value("db_partitions"));
+            }
         }
 
         if (getenv("REPLICATOR_UNDERPASS_DB_URL")) {
@@ -133,6 +148,21 @@ struct UnderpassConfig {
         if (getenv("REPLICATOR_DESTDIR_BASE")) {
             destdir_base = getenv("REPLICATOR_DESTDIR_BASE");
         }
+        if (getenv("REPLICATOR_NODE_LOCATIONS")) {
+            node_locations = getenv("REPLICATOR_NODE_LOCATIONS");
+        }
+        if (getenv("REPLICATOR_LOCATION_INDEX")) {
+            location_index = getenv("REPLICATOR_LOCATION_INDEX");
+        }
+        if (getenv("REPLICATOR_LOCATION_INDEX_FILE")) {
+            location_index_file = getenv("REPLICATOR_LOCATION_INDEX_FILE");
+        }
+        if (getenv("REPLICATOR_DB_POOL_SIZE")) {
+            db_pool_size = std::stoul(getenv("REPLICATOR_DB_POOL_SIZE"));
+        }
+        if (getenv("REPLICATOR_DB_PARTITIONS")) {
+            db_partitions = std::stoul(getenv("REPLICATOR_DB_PARTITIONS"));
+        }
         if (getenv("REPLICATOR_PLANET_SERVER")) {
             planet_server = getenv("REPLICATOR_PLANET_SERVER");
         }
@@ -158,15 +188,22 @@ struct UnderpassConfig {
     std::string planet_server;
     std::string datadir;
     std::string import;
+    std::string node_locations;                      ///< File for the node locations index, disabled if empty
+    std::string location_index = "flex_mem";         ///< Osmium index of node locations used on import
+    std::string location_index_file;                 ///< File of the import index, for the file based types
     std::vector<PlanetServer> planet_servers;
     unsigned int concurrency = 1;
     unsigned int bootstrap_page_size = 500;
+    unsigned int db_pool_size = 0;                   ///< Database connections, 0 for one for every concurrent task
+    unsigned int db_partitions = 0;                  ///< osm_id ranges of the raw tables created on import, 0 for no partitions
 
     frequency_t frequency = frequency_t::minutely;
     ptime start_time = not_a_date_time;              ///< Starting time for changesets and OSM changes import
     ptime end_time = not_a_date_time;                ///< Ending time for changesets and OSM changes import
 
     bool norefs = false;
+    bool nocopy = false;                             ///< Write changes with SQL statements instead of COPY
+    bool bulkload = false;                           ///< Import into UNLOGGED tables, finalized after the import
     bool silent = false;
     bool latest = false;
 
@@ -216,6 +253,13 @@ struct UnderpassConfig {
         std::cout << "destdir_base: " << destdir_base << std::endl;
         std::cout << "concurrency: " << concurrency << std::endl;
         std::cout << "bootstrap_page_size: " << bootstrap_page_size << std::endl;
+        std::cout << "node_locations: " << node_locations << std::endl;
+        std::cout << "location_index: " << location_index << std::endl;
+        std::cout << "location_index_file: " << location_index_file << std::endl;
+        std::cout << "db_pool_size: " << db_pool_size << std::endl;
+        std::cout << "db_partitions: " << db_partitions << std::endl;
+        std::cout << "bulkload: " << bulkload << std::endl;
+        std::cout << "nocopy: " << nocopy << std::endl;
     }
 };
 